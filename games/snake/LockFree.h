@@ -0,0 +1,77 @@
+#ifndef LOCKFREE_H
+#define LOCKFREE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free handoff between the snake client's render and network threads
+
+/**
+ * Single-producer single-consumer ring buffer.
+ * push() from one thread, pop() from another; returns false when full/empty.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    
+public:
+    bool push(const T& item) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity) return false;
+        m_items[head & (Capacity - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    bool pop(T& item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+        item = m_items[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+private:
+    std::array<T, Capacity> m_items{};
+    alignas(64) std::atomic<size_t> m_head{0}; // written by the producer
+    alignas(64) std::atomic<size_t> m_tail{0}; // written by the consumer
+};
+
+/**
+ * Triple buffer: the writer fills back() and publish()es it, the reader
+ * calls update() and reads front(). Neither side ever waits, the reader
+ * always gets the newest published value, and each slot keeps its own
+ * storage so a GameState's vectors are reused.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& back() { return m_slots[m_back]; }
+    
+    void publish() {
+        m_back = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    
+    // Reader side: true if front() changed
+    bool update() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    
+    const T& front() const { return m_slots[m_front]; }
+    
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x3;
+    static constexpr std::uint8_t FRESH = 0x4; // middle slot not yet seen by the reader
+    
+    std::array<T, 3> m_slots;
+    alignas(64) std::atomic<std::uint8_t> m_middle{1};
+    alignas(64) std::uint8_t m_back{0};  // writer only
+    alignas(64) std::uint8_t m_front{2}; // reader only
+};
+
+#endif // LOCKFREE_H
@@ -0,0 +1,285 @@
+#include "NetworkClient.h"
+#include "JsonReader.h"
+#include <iostream>
+#include <string_view>
+
+#ifdef _WIN32
+    #pragma comment(lib, "ws2_32.lib")
+#else
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <netinet/in.h>
+    #include <arpa/inet.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <cerrno>
+#endif
+
+bool NetworkClient::connect() {
+    #ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+            std::cerr << "WSAStartup failed" << std::endl;
+            return false;
+        }
+
+        m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_socket == NO_SOCKET) {
+            std::cerr << "Socket creation failed" << std::endl;
+            WSACleanup();
+            return false;
+        }
+    #else
+        m_socket = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_socket == NO_SOCKET) {
+            std::cerr << "Socket creation failed" << std::endl;
+            return false;
+        }
+    #endif
+
+    sockaddr_in serverAddr;
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(m_port);
+
+    #ifdef _WIN32
+        inet_pton(AF_INET, m_host.c_str(), &serverAddr.sin_addr);
+    #else
+        inet_aton(m_host.c_str(), &serverAddr.sin_addr);
+    #endif
+
+    if (::connect(m_socket, (sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
+        std::cerr << "Connection to server failed" << std::endl;
+        disconnect();
+        return false;
+    }
+
+    // Set non-blocking mode
+    #ifdef _WIN32
+        u_long mode = 1;
+        ioctlsocket(m_socket, FIONBIO, &mode);
+    #else
+        int flags = fcntl(m_socket, F_GETFL, 0);
+        fcntl(m_socket, F_SETFL, flags | O_NONBLOCK);
+    #endif
+
+    // Sent by the network thread with the first inputs
+    m_writer.begin();
+    writeHello(m_writer, m_binaryFrames, m_binaryFrames);
+    m_sendBuffer.assign(m_writer.finish());
+    m_sendPos = 0;
+
+    m_connected.store(true);
+    m_running.store(true);
+    m_thread = std::thread(&NetworkClient::run, this);
+    std::cout << "Connected to server at " << m_host << ":" << m_port << std::endl;
+    return true;
+}
+
+void NetworkClient::disconnect() {
+    m_running.store(false);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    if (m_socket != NO_SOCKET) {
+        #ifdef _WIN32
+            closesocket(m_socket);
+            WSACleanup();
+        #else
+            ::close(m_socket);
+        #endif
+        m_socket = NO_SOCKET;
+    }
+    m_connected.store(false);
+}
+
+bool NetworkClient::postInput(int playerId, Protocol::Direction dir, std::uint32_t seq) {
+    if (!isConnected()) return false;
+    return m_inputs.push(InputCommand{playerId, dir, seq});
+}
+
+void NetworkClient::run() {
+    while (m_running.load(std::memory_order_acquire)) {
+        if (!sendInputs() || !receiveStates()) {
+            m_connected.store(false);
+            break;
+        }
+        waitForSocket(NET_POLL_MS);
+    }
+}
+
+bool NetworkClient::sendInputs() {
+    InputCommand input;
+    while (m_inputs.pop(input)) {
+        m_writer.begin();
+        writeInput(m_writer, input.playerId, input.dir, input.seq);
+        m_sendBuffer.append(m_writer.finish());
+    }
+
+    const auto now = NetClock::now();
+    if (now >= m_nextPing) {
+        ++m_pingSeq;
+        m_pingSentAt[m_pingSeq % PINGS_IN_FLIGHT] = now;
+        m_writer.begin();
+        writePing(m_writer, m_pingSeq);
+        m_sendBuffer.append(m_writer.finish());
+        m_nextPing = now + std::chrono::milliseconds(PING_INTERVAL_MS);
+    }
+
+    while (m_sendPos < m_sendBuffer.size()) {
+        const char* data = m_sendBuffer.data() + m_sendPos;
+        const size_t size = m_sendBuffer.size() - m_sendPos;
+        #ifdef _WIN32
+            int result = ::send(m_socket, data, static_cast<int>(size), 0);
+        #else
+            ssize_t result = ::send(m_socket, data, size, 0);
+        #endif
+
+        if (result <= 0) {
+            return result < 0 && wouldBlock();
+        }
+        m_sendPos += static_cast<size_t>(result);
+    }
+
+    m_sendBuffer.clear();
+    m_sendPos = 0;
+    return true;
+}
+
+bool NetworkClient::receiveStates() {
+    // Drop lines consumed last time; what is left is one partial line
+    m_recvBuffer.erase(0, m_readPos);
+    m_readPos = 0;
+
+    // Bounded per pass; the rest waits in the socket for the next one
+    bool open = true;
+    char chunk[16384];
+    while (m_recvBuffer.size() < MAX_RECV_BUFFER) {
+        #ifdef _WIN32
+            int result = ::recv(m_socket, chunk, sizeof(chunk), 0);
+        #else
+            ssize_t result = ::recv(m_socket, chunk, sizeof(chunk), 0);
+        #endif
+
+        if (result > 0) {
+            m_recvBuffer.append(chunk, static_cast<size_t>(result));
+            continue;
+        }
+        // Closed by the server or a hard socket error
+        open = result != 0 && wouldBlock();
+        break;
+    }
+
+    // Walk the complete lines and frames. Pongs are handled wherever they
+    // are; of the snapshots only the newest matters, older ones are stale
+    // and skipped without decoding (a frame by its length prefix alone)
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(m_recvBuffer.data());
+    const size_t size = m_recvBuffer.size();
+    std::string_view line;
+    const std::uint8_t* frame = nullptr;
+    Frame::Header frameHeader;
+    size_t pos = 0;
+    while (pos < size) {
+        if (bytes[pos] == '{') {
+            const size_t newline = m_recvBuffer.find('\n', pos);
+            if (newline == std::string::npos) break;
+            std::string_view current(m_recvBuffer.data() + pos, newline - pos);
+            pos = newline + 1;
+
+            if (current.substr(0, PONG_PREFIX.size()) == PONG_PREFIX) {
+                handlePong(current);
+            } else {
+                line = current;
+                frame = nullptr;
+                ++m_received;
+            }
+            continue;
+        }
+
+        Frame::Header header;
+        if (size - pos < Frame::HEADER_SIZE) break;
+        if (!Frame::readHeader(bytes + pos, header)) {
+            std::cerr << "Corrupt frame from server" << std::endl;
+            return false;
+        }
+        if (header.payloadSize > MAX_SERVER_MESSAGE - Frame::HEADER_SIZE) {
+            std::cerr << "Oversized frame from server" << std::endl;
+            return false;
+        }
+        if (size - pos - Frame::HEADER_SIZE < header.payloadSize) break;
+        const std::uint8_t* payload = bytes + pos + Frame::HEADER_SIZE;
+        pos += Frame::HEADER_SIZE + header.payloadSize;
+
+        // Pongs are short uncompressed JSON frames
+        std::string_view text(reinterpret_cast<const char*>(payload), header.payloadSize);
+        if (!(header.flags & (Frame::FLAG_BINARY | Frame::FLAG_COMPRESSED)) &&
+            text.substr(0, PONG_PREFIX.size()) == PONG_PREFIX) {
+            handlePong(text);
+        } else {
+            frame = payload;
+            frameHeader = header;
+            line = {};
+            ++m_received;
+        }
+    }
+    m_readPos = pos;
+
+    // What is left is one line or frame still arriving; a server that never
+    // finishes it would otherwise grow the buffer forever
+    if (size - pos > MAX_SERVER_MESSAGE) {
+        std::cerr << "Oversized message from server" << std::endl;
+        return false;
+    }
+    if (line.empty() && !frame) return open;
+
+    // Decode straight into the back slot; a bad snapshot is simply not published
+    Snapshot& snapshot = m_states.back();
+    const auto decodeStart = NetClock::now();
+    const bool decoded = frame ? Frame::decodeState(frameHeader, frame, m_frameScratch, snapshot.state)
+                               : readGameState(line, snapshot.state) == ParseError::None;
+    if (decoded) {
+        snapshot.receivedAt = NetClock::now();
+        snapshot.decodeMicros = std::chrono::duration<float, std::micro>(
+            snapshot.receivedAt - decodeStart).count();
+        snapshot.received = m_received;
+        m_states.publish();
+    }
+    return open;
+}
+
+void NetworkClient::handlePong(std::string_view line) {
+    std::uint32_t seq = 0;
+    if (readPong(line, seq) != ParseError::None) return;
+
+    // Only the last PINGS_IN_FLIGHT pings are tracked
+    if (seq == 0 || seq > m_pingSeq || m_pingSeq - seq >= PINGS_IN_FLIGHT) return;
+    const float rttMs = std::chrono::duration<float, std::milli>(
+        NetClock::now() - m_pingSentAt[seq % PINGS_IN_FLIGHT]).count();
+    m_rttSamples.push(rttMs); // dropped if the reader has fallen behind
+}
+
+void NetworkClient::waitForSocket(int timeoutMs) {
+    fd_set readSet;
+    fd_set writeSet;
+    FD_ZERO(&readSet);
+    FD_ZERO(&writeSet);
+    FD_SET(m_socket, &readSet);
+    if (m_sendPos < m_sendBuffer.size()) {
+        FD_SET(m_socket, &writeSet);
+    }
+    timeval timeout{0, timeoutMs * 1000};
+
+    #ifdef _WIN32
+        ::select(0, &readSet, &writeSet, nullptr, &timeout);
+    #else
+        ::select(m_socket + 1, &readSet, &writeSet, nullptr, &timeout);
+    #endif
+}
+
+bool NetworkClient::wouldBlock() {
+    #ifdef _WIN32
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    #else
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    #endif
+}
@@ -0,0 +1,158 @@
+#ifndef NETWORKCLIENT_H
+#define NETWORKCLIENT_H
+
+#include "Frame.h"
+#include "JsonWriter.h"
+#include "LockFree.h"
+#include "Protocol.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#endif
+
+// No SFML here: shared by the snake client and snake_headless
+
+using NetClock = std::chrono::steady_clock;
+
+/// A decoded snapshot and when the network thread received it
+struct Snapshot {
+    Protocol::GameState state;
+    NetClock::time_point receivedAt;
+    float decodeMicros{0.f};  // time spent decoding this snapshot
+    std::uint64_t received{0}; // snapshots received so far, stale ones skipped included
+};
+
+/**
+ * Owns the socket on a dedicated thread: it drains and parses snapshots
+ * and sends queued inputs, so neither waits on the render loop.
+ *
+ * With binaryFrames the client asks for BinarySnapshot frames in its
+ * hello. Frames are length prefixed, so of a backlog only the newest
+ * snapshot is decoded and the others are skipped by header alone. JSON
+ * lines (sent before the hello takes effect, or by a server that ignores
+ * it) are still accepted.
+ */
+class NetworkClient {
+public:
+    static constexpr int NET_POLL_MS = 2; // network thread wait; bounds input send latency
+    static constexpr size_t INPUT_QUEUE_SIZE = 64;
+    static constexpr int PING_INTERVAL_MS = 500;
+    static constexpr size_t RTT_QUEUE_SIZE = 16;  // RTT samples awaiting pollRtt()
+    static constexpr size_t MAX_SERVER_MESSAGE = 4 << 20; // longest line or frame accepted
+    static constexpr size_t MAX_RECV_BUFFER = 8 << 20;    // bytes read per pass before parsing
+
+    NetworkClient(const std::string& host, int port, bool binaryFrames = true)
+        : m_host(host), m_port(port), m_binaryFrames(binaryFrames) {}
+
+    ~NetworkClient() {
+        disconnect();
+    }
+
+    bool connect();
+    void disconnect();
+
+    /**
+     * Queue an input for the network thread (render thread side).
+     * Returns false if disconnected or the queue is full.
+     */
+    bool postInput(int playerId, Protocol::Direction dir, std::uint32_t seq);
+
+    /**
+     * Pick up the newest snapshot published by the network thread.
+     * Returns false when none arrived since the last call; never blocks.
+     */
+    bool pollState() { return m_states.update(); }
+
+    /// Latest snapshot picked up by pollState()
+    const Snapshot& snapshot() const { return m_states.front(); }
+
+    /// Next round-trip time measured by ping/pong, in ms; false when none is waiting
+    bool pollRtt(float& rttMs) { return m_rttSamples.pop(rttMs); }
+
+    bool isConnected() const { return m_connected.load(std::memory_order_relaxed); }
+
+private:
+    #ifdef _WIN32
+        using Socket = SOCKET;
+        static constexpr Socket NO_SOCKET = INVALID_SOCKET;
+    #else
+        using Socket = int;
+        static constexpr Socket NO_SOCKET = -1;
+    #endif
+
+    struct InputCommand {
+        int playerId;
+        Protocol::Direction dir;
+        std::uint32_t seq;
+    };
+
+    std::string m_host;
+    int m_port;
+    bool m_binaryFrames;
+    Socket m_socket{NO_SOCKET};
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_connected{false};
+
+    SpscQueue<InputCommand, INPUT_QUEUE_SIZE> m_inputs;
+    TripleBuffer<Snapshot> m_states;
+    SpscQueue<float, RTT_QUEUE_SIZE> m_rttSamples;
+
+    // Network thread only
+    JsonWriter m_writer;
+    // Bytes received; [m_readPos, end) is a line or frame still arriving
+    std::string m_recvBuffer;
+    size_t m_readPos{0};
+    std::uint64_t m_received{0};
+    std::string m_frameScratch; // decompressed frame payload
+    // Input lines not yet accepted by the socket; [m_sendPos, end) is left to send
+    std::string m_sendBuffer;
+    size_t m_sendPos{0};
+    // Pings in flight, indexed by seq; a late pong whose slot was reused is ignored
+    static constexpr size_t PINGS_IN_FLIGHT = 8;
+    std::array<NetClock::time_point, PINGS_IN_FLIGHT> m_pingSentAt{};
+    std::uint32_t m_pingSeq{0};
+    NetClock::time_point m_nextPing{};
+
+    void run();
+
+    /**
+     * Queue the posted inputs (and a ping when one is due) and send as much
+     * as the socket takes without blocking; a partial line is finished on a
+     * later pass.
+     * Returns false on a hard socket error.
+     */
+    bool sendInputs();
+
+    /**
+     * Drain the socket (up to MAX_RECV_BUFFER per pass), handle pongs and
+     * publish the newest complete snapshot; older ones are counted in
+     * m_received but never decoded.
+     * Returns false once the connection is closed or broken: a corrupt
+     * frame header, after which the stream cannot be resynced, or a line or
+     * frame longer than MAX_SERVER_MESSAGE.
+     */
+    bool receiveStates();
+
+    void handlePong(std::string_view line);
+
+    // Sleep until data arrives, pending output can go out, or timeoutMs elapses
+    // (newly posted inputs wait at most that long)
+    void waitForSocket(int timeoutMs);
+
+    static bool wouldBlock();
+};
+
+#endif // NETWORKCLIENT_H
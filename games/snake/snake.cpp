@@ -1,22 +1,17 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
+#include "NetworkClient.h"
+#include "Protocol.h"
 #include <vector>
 #include <array>
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <optional>
-
-#ifdef _WIN32
-    #include <winsock2.h>
-    #include <ws2tcpip.h>
-    #pragma comment(lib, "ws2_32.lib")
-#else
-    #include <sys/socket.h>
-    #include <netinet/in.h>
-    #include <arpa/inet.h>
-    #include <unistd.h>
-#endif
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
 
 // ============================================================
 // Config
@@ -26,367 +21,776 @@ constexpr int GRID_SIZE = 20;
 constexpr int GRID_W = 60;
 constexpr int GRID_H = 40;
 constexpr int MAX_PLAYERS = 4;
+constexpr int STATE_TIMEOUT_MS = 2000; // no snapshot for this long = connection lost
+constexpr float INPUT_RATE_PER_SEC = 30.f; // sustained input sends allowed per client
+constexpr float INPUT_BURST = 8.f;         // sends allowed back to back
+constexpr float AXIS_THRESHOLD = 50.f;     // joystick deflection that counts as a direction
+constexpr float EXPECTED_TICK_MS = 120.f; // first guess, refined from snapshot arrivals
+constexpr size_t SNAPSHOT_HISTORY = 8;    // snapshots kept for interpolation
+constexpr size_t PREDICTED_INPUTS = 16;   // unacknowledged inputs kept per local player
+constexpr int PREDICTION_TIMEOUT_MS = 1000; // unacknowledged this long = lost, stop predicting it
 
 // ============================================================
-// Shared types (matching server Protocol.h)
+// Shared types (protocol library)
 // ============================================================
 
-enum class Direction { Up = 0, Down = 1, Left = 2, Right = 3 };
-
-struct Vec2 {
-    int x{};
-    int y{};
-};
-
-struct PlayerState {
-    int id{};
-    bool alive{true};
-    Direction dir{Direction::Right};
-    std::vector<Vec2> body;
-    int score{0};
-};
-
-struct GameState {
-    std::vector<PlayerState> players;
-    std::vector<Vec2> food;
-    bool gameActive{false};
-};
+using Protocol::Direction;
+using Protocol::GameState;
 
 // ============================================================
-// NetworkClient - handles connection to game server
+// ClientMetrics - latency and frame-time statistics for the HUD
 // ============================================================
 
-class NetworkClient {
+/**
+ * Distribution of the last WINDOW samples of one metric in BUCKETS
+ * buckets of a fixed width (the last bucket also takes everything above).
+ * Adding a sample is O(1): the sample it replaces leaves its bucket.
+ */
+class RollingHistogram {
 public:
-    NetworkClient(const std::string& host, int port)
-        : m_host(host), m_port(port), m_connected(false) {
-        #ifdef _WIN32
-            m_socket = INVALID_SOCKET;
-        #else
-            m_socket = -1;
-        #endif
+    static constexpr size_t WINDOW = 256;
+    static constexpr size_t BUCKETS = 32;
+    
+    explicit RollingHistogram(float bucketWidth) : m_bucketWidth(bucketWidth) {}
+    
+    void add(float value) {
+        value = std::max(value, 0.f);
+        if (m_count == WINDOW) {
+            const float old = m_samples[m_next];
+            --m_buckets[bucketOf(old)];
+            m_sum -= old;
+        } else {
+            ++m_count;
+        }
+        m_samples[m_next] = value;
+        m_next = (m_next + 1) % WINDOW;
+        ++m_buckets[bucketOf(value)];
+        m_sum += value;
     }
     
-    ~NetworkClient() {
-        disconnect();
+    size_t count() const { return m_count; }
+    float mean() const { return m_count > 0 ? static_cast<float>(m_sum / m_count) : 0.f; }
+    std::uint32_t bucket(size_t index) const { return m_buckets[index]; }
+    
+    /// Upper edge of the bucket holding quantile q (0..1); exact max in the last bucket
+    float percentile(float q) const {
+        if (m_count == 0) return 0.f;
+        const size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(q * m_count)));
+        size_t seen = 0;
+        for (size_t b = 0; b + 1 < BUCKETS; ++b) {
+            seen += m_buckets[b];
+            if (seen >= rank) return (b + 1) * m_bucketWidth;
+        }
+        return max();
     }
     
-    bool connect() {
-        #ifdef _WIN32
-            WSADATA wsaData;
-            if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-                std::cerr << "WSAStartup failed" << std::endl;
-                return false;
-            }
-            
-            m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-            if (m_socket == INVALID_SOCKET) {
-                std::cerr << "Socket creation failed" << std::endl;
-                WSACleanup();
-                return false;
-            }
-        #else
-            m_socket = socket(AF_INET, SOCK_STREAM, 0);
-            if (m_socket < 0) {
-                std::cerr << "Socket creation failed" << std::endl;
-                return false;
-            }
-        #endif
-        
-        sockaddr_in serverAddr;
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_port = htons(m_port);
-        
-        #ifdef _WIN32
-            inet_pton(AF_INET, m_host.c_str(), &serverAddr.sin_addr);
-        #else
-            inet_aton(m_host.c_str(), &serverAddr.sin_addr);
-        #endif
-        
-        if (::connect(m_socket, (sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
-            std::cerr << "Connection to server failed" << std::endl;
-            disconnect();
-            return false;
-        }
-        
-        // Set non-blocking mode
-        #ifdef _WIN32
-            u_long mode = 1;
-            ioctlsocket(m_socket, FIONBIO, &mode);
-        #else
-            int flags = fcntl(m_socket, F_GETFL, 0);
-            fcntl(m_socket, F_SETFL, flags | O_NONBLOCK);
-        #endif
-        
-        m_connected = true;
-        std::cout << "Connected to server at " << m_host << ":" << m_port << std::endl;
-        return true;
+    float max() const {
+        float result = 0.f;
+        for (size_t i = 0; i < m_count; ++i) result = std::max(result, m_samples[i]);
+        return result;
     }
     
-    void disconnect() {
-        if (m_connected) {
-            #ifdef _WIN32
-                closesocket(m_socket);
-                WSACleanup();
-                m_socket = INVALID_SOCKET;
-            #else
-                ::close(m_socket);
-                m_socket = -1;
-            #endif
-            m_connected = false;
-        }
+private:
+    float m_bucketWidth;
+    std::array<float, WINDOW> m_samples{};
+    std::array<std::uint32_t, BUCKETS> m_buckets{};
+    size_t m_next{0};
+    size_t m_count{0};
+    double m_sum{0.0};
+    
+    size_t bucketOf(float value) const {
+        return std::min(static_cast<size_t>(value / m_bucketWidth), BUCKETS - 1);
     }
+};
+
+/// Everything the HUD shows; collected every frame, shown or not
+class ClientMetrics {
+public:
+    RollingHistogram rttMs{0.5f};
+    RollingHistogram jitterMs{0.5f};      // snapshot arrival deviation from the mean interval
+    RollingHistogram decodeUs{10.f};
+    RollingHistogram renderMs{0.1f};      // CPU time to build and submit the board
+    RollingHistogram ackLatencyMs{10.f};  // local input sent -> acknowledged by a snapshot
+    std::uint64_t droppedSnapshots{0};    // stale on arrival: the network thread never decoded them
+    std::uint64_t heldFrames{0};          // rendered with no newer snapshot to move towards
+    size_t dirtyCells{0};                 // board cells the renderer redrew last frame
     
-    bool sendInput(int playerId, Direction dir) {
-        if (!m_connected) return false;
-        
-        std::ostringstream oss;
-        oss << "{\"type\":\"input\",\"playerId\":" << playerId
-            << ",\"direction\":" << static_cast<int>(dir) << "}\n";
-        std::string msg = oss.str();
-        
-        #ifdef _WIN32
-            int result = ::send(m_socket, msg.c_str(), static_cast<int>(msg.size()), 0);
-        #else
-            ssize_t result = ::send(m_socket, msg.c_str(), msg.size(), 0);
-        #endif
-        
-        return result > 0;
+    void addSnapshot(const Snapshot& snapshot) {
+        decodeUs.add(snapshot.decodeMicros);
+        if (m_lastReceived > 0) {
+            droppedSnapshots += snapshot.received - m_lastReceived - 1;
+            
+            const float delta = std::chrono::duration<float, std::milli>(
+                snapshot.receivedAt - m_lastArrival).count();
+            // Stalls (window dragged, debugger) are not network jitter
+            if (delta > 0.f && delta < 4.f * m_intervalMs) {
+                jitterMs.add(std::abs(delta - m_intervalMs));
+                m_intervalMs += (delta - m_intervalMs) / 16.f;
+            }
+        }
+        m_lastReceived = snapshot.received;
+        m_lastArrival = snapshot.receivedAt;
     }
     
-    GameState receiveState() {
-        GameState state;
-        if (!m_connected) return state;
-        
-        char buffer[8192];
-        #ifdef _WIN32
-            int result = ::recv(m_socket, buffer, sizeof(buffer) - 1, 0);
-        #else
-            ssize_t result = ::recv(m_socket, buffer, sizeof(buffer) - 1, 0);
-        #endif
-        
-        if (result <= 0) {
-            return state;
+private:
+    std::uint64_t m_lastReceived{0};
+    NetClock::time_point m_lastArrival;
+    float m_intervalMs{EXPECTED_TICK_MS};
+};
+
+// ============================================================
+// SnapshotInterpolator - smooth motion between server ticks
+// ============================================================
+
+/// Two snapshots to blend (alpha 0 shows from, 1 shows to), plus the newest one
+struct InterpolatedFrame {
+    const GameState* from;
+    const GameState* to;
+    float alpha;
+    const GameState* newest;
+    float progress; // fraction of a tick since newest arrived, 0..1
+};
+
+/**
+ * Keeps the last few snapshots with their arrival times and renders one
+ * tick behind the newest, so there is almost always a newer snapshot to
+ * move towards. The delay follows the measured tick interval plus twice
+ * the arrival jitter. Snapshots are copied into a fixed ring whose states
+ * keep their vectors, so nothing is allocated per frame.
+ */
+class SnapshotInterpolator {
+public:
+    void push(const Snapshot& snapshot) {
+        if (m_count > 0) {
+            const float delta = std::chrono::duration<float, std::milli>(
+                snapshot.receivedAt - m_history[m_newest].receivedAt).count();
+            // Ignore stalls (window dragged, debugger) so they do not skew the estimate
+            if (delta > 0.f && delta < 4.f * m_intervalMs) {
+                m_jitterMs += (std::abs(delta - m_intervalMs) - m_jitterMs) / 16.f;
+                m_intervalMs += (delta - m_intervalMs) / 16.f;
+            }
         }
         
-        buffer[result] = '\0';
-        std::string data(buffer);
-        
-        // Parse JSON (simple parser)
-        state = parseGameState(data);
-        return state;
+        m_newest = (m_newest + 1) % SNAPSHOT_HISTORY;
+        m_history[m_newest] = snapshot; // copy-assign reuses the slot's storage
+        if (m_count < SNAPSHOT_HISTORY) ++m_count;
     }
     
-    bool isConnected() const { return m_connected; }
+    InterpolatedFrame sample(NetClock::time_point now) const {
+        InterpolatedFrame frame = blend(now);
+        
+        const Snapshot& newest = at(0);
+        const float sinceNewest = std::chrono::duration<float, std::milli>(now - newest.receivedAt).count();
+        frame.newest = &newest.state;
+        frame.progress = std::clamp(sinceNewest / m_intervalMs, 0.f, 1.f);
+        return frame;
+    }
     
 private:
-    std::string m_host;
-    int m_port;
-    bool m_connected;
+    std::array<Snapshot, SNAPSHOT_HISTORY> m_history;
+    size_t m_newest{0};
+    size_t m_count{0};
+    float m_intervalMs{EXPECTED_TICK_MS};
+    float m_jitterMs{0.f};
     
-    #ifdef _WIN32
-        SOCKET m_socket;
-    #else
-        int m_socket;
-    #endif
+    // age 0 is the newest snapshot
+    const Snapshot& at(size_t age) const {
+        return m_history[(m_newest + SNAPSHOT_HISTORY - age) % SNAPSHOT_HISTORY];
+    }
     
-    GameState parseGameState(const std::string& json) {
-        GameState state;
-        
-        // Simple JSON parser - in production, use a proper JSON library
-        size_t activePos = json.find("\"active\":");
-        if (activePos != std::string::npos) {
-            state.gameActive = json.find("true", activePos) != std::string::npos;
-        }
-        
-        // Parse players
-        size_t playersPos = json.find("\"players\":[");
-        if (playersPos != std::string::npos) {
-            state.players = parsePlayers(json, playersPos);
-        }
-        
-        // Parse food
-        size_t foodPos = json.find("\"food\":[");
-        if (foodPos != std::string::npos) {
-            state.food = parseFood(json, foodPos);
+    // Snapshots around the render time, one tick behind now
+    InterpolatedFrame blend(NetClock::time_point now) const {
+        const GameState& newest = at(0).state;
+        if (m_count < 2) return {&newest, &newest, 1.f};
+        
+        const auto delay = std::chrono::duration<float, std::milli>(m_intervalMs + 2.f * m_jitterMs);
+        const auto renderTime = now - std::chrono::duration_cast<NetClock::duration>(delay);
+        
+        // Newest snapshot at or before renderTime, and the one after it
+        for (size_t age = 0; age + 1 < m_count; ++age) {
+            const Snapshot& to = at(age);
+            const Snapshot& from = at(age + 1);
+            if (from.receivedAt > renderTime) continue;
+            
+            if (age == 0 && renderTime >= to.receivedAt) {
+                return {&to.state, &to.state, 1.f}; // caught up: hold the newest
+            }
+            const float span = std::chrono::duration<float>(to.receivedAt - from.receivedAt).count();
+            const float elapsed = std::chrono::duration<float>(renderTime - from.receivedAt).count();
+            const float alpha = span > 0.f ? std::min(elapsed / span, 1.f) : 1.f;
+            return {&from.state, &to.state, alpha};
         }
         
-        return state;
+        // renderTime is older than the whole history
+        const GameState& oldest = at(m_count - 1).state;
+        return {&oldest, &oldest, 1.f};
+    }
+};
+
+// ============================================================
+// InputPredictor - client-side prediction for local snakes
+// ============================================================
+
+/**
+ * Remembers the inputs sent for each local player until a snapshot
+ * acknowledges them. The predicted direction is the snapshot's direction
+ * with the unacknowledged inputs replayed on top, under the server's rule
+ * that a snake cannot reverse. Each new snapshot is a rollback point:
+ * acknowledged inputs are dropped and the rest replayed on it.
+ */
+class InputPredictor {
+public:
+    /// Record a local input; returns the sequence number to send with it
+    std::uint32_t record(int playerId, Direction dir, NetClock::time_point now) {
+        const std::uint32_t seq = ++m_lastSeq;
+        if (playerId < 0 || playerId >= MAX_PLAYERS) return seq;
+        
+        Pending& pending = m_players[playerId];
+        if (pending.count == PREDICTED_INPUTS) pending.popFront(); // oldest is surely applied by now
+        pending.inputs[(pending.first + pending.count) % PREDICTED_INPUTS] = {seq, dir, now};
+        ++pending.count;
+        m_local[playerId] = true;
+        return seq;
     }
     
-    std::vector<PlayerState> parsePlayers(const std::string& json, size_t start) {
-        std::vector<PlayerState> players;
-        
-        size_t pos = start + 11; // Skip "players":["
-        
-        for (int i = 0; i < MAX_PLAYERS; ++i) {
-            size_t idPos = json.find("\"id\":", pos);
-            if (idPos == std::string::npos) break;
-            
-            PlayerState p;
-            
-            // Parse id
-            idPos += 5;
-            p.id = std::stoi(json.substr(idPos, 1));
-            
-            // Parse alive
-            size_t alivePos = json.find("\"alive\":", idPos);
-            if (alivePos != std::string::npos) {
-                p.alive = json.find("true", alivePos) < json.find("false", alivePos);
-            }
-            
-            // Parse direction
-            size_t dirPos = json.find("\"dir\":", alivePos);
-            if (dirPos != std::string::npos) {
-                dirPos += 6;
-                p.dir = static_cast<Direction>(std::stoi(json.substr(dirPos, 1)));
-            }
-            
-            // Parse score
-            size_t scorePos = json.find("\"score\":", dirPos);
-            if (scorePos != std::string::npos) {
-                scorePos += 8;
-                size_t endPos = json.find_first_of(",}", scorePos);
-                p.score = std::stoi(json.substr(scorePos, endPos - scorePos));
-            }
+    /// Forget an input that could not be sent
+    void cancel(int playerId, std::uint32_t seq) {
+        if (playerId < 0 || playerId >= MAX_PLAYERS) return;
+        Pending& pending = m_players[playerId];
+        if (pending.count > 0 && pending.back().seq == seq) --pending.count;
+    }
+    
+    /**
+     * Drop the inputs an authoritative snapshot has applied (or that were
+     * lost); ackLatencyMs, if given, gets the send-to-ack time of each
+     * applied one.
+     */
+    void reconcile(const GameState& state, NetClock::time_point now,
+                   RollingHistogram* ackLatencyMs = nullptr) {
+        const auto timeout = std::chrono::milliseconds(PREDICTION_TIMEOUT_MS);
+        for (const auto& p : state.players) {
+            if (!isLocal(p.id)) continue;
             
-            // Parse body
-            size_t bodyPos = json.find("\"body\":[", scorePos);
-            if (bodyPos != std::string::npos) {
-                p.body = parseVec2Array(json, bodyPos + 8);
+            // An ack above our last seq belongs to an earlier client on this player
+            const std::uint32_t ack = p.ack <= m_lastSeq ? p.ack : 0;
+            Pending& pending = m_players[p.id];
+            while (pending.count > 0 &&
+                   (pending.front().seq <= ack || now - pending.front().sentAt > timeout)) {
+                if (ackLatencyMs && pending.front().seq <= ack) {
+                    ackLatencyMs->add(std::chrono::duration<float, std::milli>(
+                        now - pending.front().sentAt).count());
+                }
+                pending.popFront();
             }
-            
-            players.push_back(p);
-            pos = json.find("},{", bodyPos);
-            if (pos == std::string::npos) break;
-            pos += 2;
         }
-        
-        return players;
     }
     
-    std::vector<Vec2> parseFood(const std::string& json, size_t start) {
-        return parseVec2Array(json, start + 8); // Skip "food":["
+    bool isLocal(int playerId) const {
+        return playerId >= 0 && playerId < MAX_PLAYERS && m_local[playerId];
     }
     
-    std::vector<Vec2> parseVec2Array(const std::string& json, size_t start) {
-        std::vector<Vec2> result;
-        size_t pos = start;
-        
-        while (true) {
-            size_t xPos = json.find("\"x\":", pos);
-            if (xPos == std::string::npos || xPos > json.find("]", pos)) break;
-            
-            Vec2 v;
-            xPos += 4;
-            size_t commaPos = json.find(",", xPos);
-            v.x = std::stoi(json.substr(xPos, commaPos - xPos));
-            
-            size_t yPos = json.find("\"y\":", commaPos);
-            yPos += 4;
-            size_t endPos = json.find("}", yPos);
-            v.y = std::stoi(json.substr(yPos, endPos - yPos));
-            
-            result.push_back(v);
-            
-            pos = json.find(",{", endPos);
-            if (pos == std::string::npos) break;
-            pos += 2;
+    /// Direction p will move in next tick, with unacknowledged inputs replayed
+    Direction predictedDir(const Protocol::PlayerState& p) const {
+        Direction dir = p.dir;
+        if (!isLocal(p.id) || !p.alive) return dir;
+        
+        const Pending& pending = m_players[p.id];
+        for (size_t i = 0; i < pending.count; ++i) {
+            const Direction wanted = pending.inputs[(pending.first + i) % PREDICTED_INPUTS].dir;
+            // Up/Down and Left/Right differ only in their lowest bit
+            const bool opposite = (static_cast<int>(dir) ^ static_cast<int>(wanted)) == 1;
+            if (!opposite) dir = wanted;
         }
-        
-        return result;
+        return dir;
     }
+    
+private:
+    struct Input {
+        std::uint32_t seq;
+        Direction dir;
+        NetClock::time_point sentAt;
+    };
+    
+    // Unacknowledged inputs of one player, oldest first
+    struct Pending {
+        std::array<Input, PREDICTED_INPUTS> inputs{};
+        size_t first{0};
+        size_t count{0};
+        
+        const Input& front() const { return inputs[first]; }
+        const Input& back() const { return inputs[(first + count - 1) % PREDICTED_INPUTS]; }
+        void popFront() {
+            first = (first + 1) % PREDICTED_INPUTS;
+            --count;
+        }
+    };
+    
+    std::array<Pending, MAX_PLAYERS> m_players{};
+    std::array<bool, MAX_PLAYERS> m_local{};
+    std::uint32_t m_lastSeq{0};
 };
 
 // ============================================================
-// InputAdapter - reads local keyboard/controller input
+// InputAdapter - turns keyboard/controller events into inputs
 // ============================================================
 
+/// A direction change for one local player
+struct PlayerInput {
+    int player;
+    Direction dir;
+};
+
 class InputAdapter {
 public:
-    static std::optional<Direction> getInput(int player) {
-        std::optional<Direction> dir;
-        
+    /**
+     * Input carried by a window event, if any: arrow keys steer player 0,
+     * joystick N steers player N (the stick's dominant axis wins).
+     */
+    static std::optional<PlayerInput> fromEvent(const sf::Event& event) {
         // Keyboard input (player 0)
-        if (player == 0) {
-            if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up)) {
-                dir = Direction::Up;
-            } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down)) {
-                dir = Direction::Down;
-            } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left)) {
-                dir = Direction::Left;
-            } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right)) {
-                dir = Direction::Right;
+        if (const auto* key = event.getIf<sf::Event::KeyPressed>()) {
+            switch (key->code) {
+                case sf::Keyboard::Key::Up:    return PlayerInput{0, Direction::Up};
+                case sf::Keyboard::Key::Down:  return PlayerInput{0, Direction::Down};
+                case sf::Keyboard::Key::Left:  return PlayerInput{0, Direction::Left};
+                case sf::Keyboard::Key::Right: return PlayerInput{0, Direction::Right};
+                default:                       return std::nullopt;
             }
         }
         
         // Controller input
-        if (!dir && sf::Joystick::isConnected(player)) {
+        if (const auto* moved = event.getIf<sf::Event::JoystickMoved>()) {
+            const unsigned player = moved->joystickId;
+            if (player >= static_cast<unsigned>(MAX_PLAYERS) ||
+                (moved->axis != sf::Joystick::Axis::X && moved->axis != sf::Joystick::Axis::Y)) {
+                return std::nullopt;
+            }
+            
+            // The event carries one axis; read the other to find the dominant one
             float x = sf::Joystick::getAxisPosition(player, sf::Joystick::Axis::X);
             float y = sf::Joystick::getAxisPosition(player, sf::Joystick::Axis::Y);
             
+            std::optional<Direction> dir;
             if (std::abs(x) > std::abs(y)) {
-                if (x > 50) {
+                if (x > AXIS_THRESHOLD) {
                     dir = Direction::Right;
-                } else if (x < -50) {
+                } else if (x < -AXIS_THRESHOLD) {
                     dir = Direction::Left;
                 }
             } else {
-                if (y > 50) {
+                if (y > AXIS_THRESHOLD) {
                     dir = Direction::Down;
-                } else if (y < -50) {
+                } else if (y < -AXIS_THRESHOLD) {
                     dir = Direction::Up;
                 }
             }
+            if (dir) return PlayerInput{static_cast<int>(player), *dir};
         }
         
-        return dir; // std::nullopt when no input is active
+        return std::nullopt;
     }
 };
 
+/**
+ * Token bucket limiting how fast this client sends inputs: bursts of up
+ * to `burst` sends, refilled at `ratePerSecond`.
+ */
+class TokenBucket {
+public:
+    TokenBucket(float ratePerSecond, float burst)
+        : m_ratePerSecond(ratePerSecond), m_burst(burst), m_tokens(burst) {}
+    
+    bool tryTake(NetClock::time_point now) {
+        const float elapsed = std::chrono::duration<float>(now - m_lastRefill).count();
+        m_tokens = std::min(m_burst, m_tokens + elapsed * m_ratePerSecond);
+        m_lastRefill = now;
+        
+        if (m_tokens < 1.f) return false;
+        m_tokens -= 1.f;
+        return true;
+    }
+    
+private:
+    float m_ratePerSecond;
+    float m_burst;
+    float m_tokens;
+    NetClock::time_point m_lastRefill{NetClock::now()};
+};
+
 // ============================================================
 // Renderer - renders game state
 // ============================================================
 
+/**
+ * Keeps the board's static cells (food and the snake bodies between
+ * their moving heads and tails) in a render texture the size of the
+ * window. Each frame the static cells are compared with what the texture
+ * holds and only the changed ones are redrawn into it; the texture is then
+ * blitted and the few moving cells drawn on top, all from vertex arrays
+ * whose storage is kept between frames. If the render texture cannot be
+ * created, the static cells are drawn straight to the window instead.
+ */
 class Renderer {
 public:
-    static void drawState(sf::RenderWindow& window, const GameState& state) {
-        window.clear(sf::Color(30, 30, 30));
+    Renderer() {
+        m_wanted.resize(GRID_W * GRID_H, Cell::Empty);
+        m_cached.resize(GRID_W * GRID_H, Cell::Empty);
+        if (m_layer.resize({GRID_W * GRID_SIZE, GRID_H * GRID_SIZE})) {
+            m_layer.clear(BACKGROUND_COLOR);
+            m_layer.display();
+            m_layerSprite.emplace(m_layer.getTexture());
+        } else {
+            std::cerr << "Board cache unavailable, redrawing every cell" << std::endl;
+        }
+    }
+    
+    /**
+     * Draw frame.to, with each snake's head and tail slid from their
+     * positions in frame.from by frame.alpha (the cells in between are
+     * shared by both snapshots). Local snakes are drawn from frame.newest
+     * instead, moving ahead in their predicted direction.
+     */
+    void drawState(sf::RenderWindow& window, const InterpolatedFrame& frame,
+                   const InputPredictor& predictor) {
+        const GameState& state = *frame.to;
+        
+        // Static cells
+        std::fill(m_wanted.begin(), m_wanted.end(), Cell::Empty);
+        for (const auto& f : state.food) {
+            mark(f, Cell::Food);
+        }
+        for (const auto& p : state.players) {
+            if (!p.alive || predictor.isLocal(p.id)) continue;
+            for (size_t i = 1; i + 1 < p.body.size(); ++i) {
+                mark(p.body[i], Cell::Body);
+            }
+        }
+        for (const auto& p : frame.newest->players) {
+            if (!p.alive || !predictor.isLocal(p.id)) continue;
+            for (size_t i = 0; i + 1 < p.body.size(); ++i) {
+                mark(p.body[i], Cell::Body);
+            }
+        }
+        
+        if (m_layerSprite) {
+            updateLayer();
+            window.draw(*m_layerSprite); // covers the whole window, no clear needed
+        } else {
+            window.clear(BACKGROUND_COLOR);
+        }
         
-        sf::RectangleShape cell(sf::Vector2f(GRID_SIZE - 2.f, GRID_SIZE - 2.f));
+        // Moving cells: two per snake at most, plus every static cell without the cache
+        size_t cellCount = 2 * (state.players.size() + frame.newest->players.size());
+        if (!m_layerSprite) cellCount += m_wanted.size();
+        m_cells.resize(cellCount * VERTICES_PER_CELL);
+        m_next = 0;
+        
+        if (!m_layerSprite) {
+            for (size_t i = 0; i < m_wanted.size(); ++i) {
+                if (m_wanted[i] != Cell::Empty) {
+                    addCell(m_cells, m_next, static_cast<float>(i % GRID_W),
+                            static_cast<float>(i / GRID_W), cellColor(m_wanted[i]));
+                }
+            }
+        }
         
-        // Draw food
-        for (const auto& f : state.food) {
-            cell.setFillColor(sf::Color::Red);
-            cell.setPosition(sf::Vector2f(
-                f.x * GRID_SIZE + 1.f,
-                f.y * GRID_SIZE + 1.f
-            ));
-            window.draw(cell);
+        for (size_t index = 0; index < state.players.size(); ++index) {
+            const auto& p = state.players[index];
+            if (!p.alive || p.body.empty() || predictor.isLocal(p.id)) continue;
+            
+            const Protocol::PlayerState* prev = findPlayer(*frame.from, p.id, index);
+            const bool slide = prev && prev->alive && !prev->body.empty();
+            const size_t last = p.body.size() - 1;
+            if (last > 0) {
+                addSliding(slide ? &prev->body.back() : nullptr, p.body[last], frame.alpha, BODY_COLOR);
+            }
+            addSliding(slide ? &prev->body.front() : nullptr, p.body[0], frame.alpha, headColor(p.id));
+        }
+        
+        const float progress = frame.newest->gameActive ? frame.progress : 0.f;
+        for (const auto& p : frame.newest->players) {
+            if (p.alive && !p.body.empty() && predictor.isLocal(p.id)) {
+                drawPredicted(p, predictor.predictedDir(p), progress);
+            }
+        }
+        
+        m_cells.resize(m_next);
+        window.draw(m_cells);
+    }
+    
+    /// Cells redrawn into the cached layer by the last drawState()
+    size_t lastDirtyCells() const { return m_lastDirtyCells; }
+    
+private:
+    enum class Cell : std::uint8_t { Empty, Food, Body };
+    
+    static constexpr size_t VERTICES_PER_CELL = 6;
+    static inline const sf::Color BACKGROUND_COLOR{30, 30, 30};
+    static inline const sf::Color BODY_COLOR{120, 120, 120};
+    
+    // Static cells wanted this frame, and what the layer currently shows
+    std::vector<Cell> m_wanted;
+    std::vector<Cell> m_cached;
+    sf::RenderTexture m_layer;
+    std::optional<sf::Sprite> m_layerSprite; // empty if the layer could not be created
+    sf::VertexArray m_dirty{sf::PrimitiveType::Triangles};
+    size_t m_lastDirtyCells{0};
+    
+    sf::VertexArray m_cells{sf::PrimitiveType::Triangles};
+    size_t m_next{0};
+    
+    void mark(const Protocol::Vec2& cell, Cell kind) {
+        if (cell.x < 0 || cell.x >= GRID_W || cell.y < 0 || cell.y >= GRID_H) return;
+        m_wanted[cell.y * GRID_W + cell.x] = kind;
+    }
+    
+    static sf::Color cellColor(Cell kind) {
+        switch (kind) {
+            case Cell::Food: return sf::Color::Red;
+            case Cell::Body: return BODY_COLOR;
+            default:         return BACKGROUND_COLOR;
         }
+    }
+    
+    // Redraw the static cells that changed since the last frame (a freed cell
+    // is painted over with the background)
+    void updateLayer() {
+        m_dirty.resize(m_wanted.size() * VERTICES_PER_CELL);
+        size_t next = 0;
+        for (size_t i = 0; i < m_wanted.size(); ++i) {
+            if (m_wanted[i] == m_cached[i]) continue;
+            addCell(m_dirty, next, static_cast<float>(i % GRID_W), static_cast<float>(i / GRID_W),
+                    cellColor(m_wanted[i]));
+            m_cached[i] = m_wanted[i];
+        }
+        m_lastDirtyCells = next / VERTICES_PER_CELL;
+        if (next == 0) return;
         
-        // Draw players
-        static std::array<sf::Color, 4> colors{
+        m_dirty.resize(next);
+        m_layer.draw(m_dirty);
+        m_layer.display();
+    }
+    
+    // Players usually keep their index between snapshots; search only if not
+    static const Protocol::PlayerState* findPlayer(const GameState& state, int id, size_t hint) {
+        if (hint < state.players.size() && state.players[hint].id == id) {
+            return &state.players[hint];
+        }
+        for (const auto& p : state.players) {
+            if (p.id == id) return &p;
+        }
+        return nullptr;
+    }
+    
+    // Cell moving from -> to; jumps of more than one cell (respawn, missed tick) are not slid
+    void addSliding(const Protocol::Vec2* from, const Protocol::Vec2& to, float alpha, sf::Color color) {
+        if (!from || std::abs(to.x - from->x) + std::abs(to.y - from->y) > 1) {
+            addCell(m_cells, m_next, to.x, to.y, color);
+            return;
+        }
+        addCell(m_cells, m_next, from->x + (to.x - from->x) * alpha,
+                from->y + (to.y - from->y) * alpha, color);
+    }
+    
+    /**
+     * Moving cells of snake p as of its last snapshot, advanced by progress
+     * of a tick: the head leaves its cell in direction dir and the tail
+     * follows the body (a grown snake's repeated tail cell stays put). The
+     * cells they leave are part of the static layer.
+     */
+    void drawPredicted(const Protocol::PlayerState& p, Direction dir, float progress) {
+        const auto& body = p.body;
+        if (body.size() > 1) {
+            addSliding(&body[body.size() - 1], body[body.size() - 2], progress, BODY_COLOR);
+        }
+        
+        const int dx = (dir == Direction::Right) - (dir == Direction::Left);
+        const int dy = (dir == Direction::Down) - (dir == Direction::Up);
+        addCell(m_cells, m_next, body[0].x + dx * progress, body[0].y + dy * progress, headColor(p.id));
+    }
+    
+    static sf::Color headColor(int id) {
+        static const std::array<sf::Color, 4> colors{
             sf::Color::Green,
             sf::Color::Blue,
             sf::Color(255, 165, 0), // Orange
             sf::Color::Yellow
         };
+        return colors[id % colors.size()];
+    }
+    
+    // Fill the six vertices at cells[next] with one grid cell (1px gap on each side)
+    static void addCell(sf::VertexArray& cells, size_t& next, float x, float y, sf::Color color) {
+        const float left = x * GRID_SIZE + 1.f;
+        const float top = y * GRID_SIZE + 1.f;
+        const float right = left + GRID_SIZE - 2.f;
+        const float bottom = top + GRID_SIZE - 2.f;
+        
+        sf::Vertex* v = &cells[next];
+        next += VERTICES_PER_CELL;
+        
+        v[0].position = {left, top};
+        v[1].position = {right, top};
+        v[2].position = {left, bottom};
+        v[3].position = {left, bottom};
+        v[4].position = {right, top};
+        v[5].position = {right, bottom};
+        for (size_t i = 0; i < VERTICES_PER_CELL; ++i) v[i].color = color;
+    }
+};
+
+// ============================================================
+// Hud - latency and frame-time overlay (F3)
+// ============================================================
+
+/**
+ * One row per metric (p50/p95/max and its histogram bars) plus the drop
+ * counters, over a translucent panel. Text and bars are rebuilt every
+ * REFRESH_MS only; other frames redraw them as they are, which keeps the
+ * overlay well under 0.1 ms a frame. Bars still show without a font.
+ */
+class Hud {
+public:
+    static constexpr int REFRESH_MS = 250;
+    
+    Hud() {
+        for (const char* path : FONT_PATHS) {
+            if (m_font.openFromFile(path)) {
+                m_fontLoaded = true;
+                break;
+            }
+        }
+        if (!m_fontLoaded) return;
         
-        for (const auto& p : state.players) {
-            if (!p.alive) continue;
+        for (size_t row = 0; row < ROWS + 1; ++row) {
+            sf::Text& text = m_rows.emplace_back(m_font);
+            text.setCharacterSize(CHARACTER_SIZE);
+            text.setFillColor(sf::Color::White);
+            text.setPosition({PANEL_X + PADDING, rowTop(row)});
+        }
+    }
+    
+    void toggle() {
+        m_visible = !m_visible;
+        m_nextRefresh = {}; // show current numbers right away
+    }
+    
+    void draw(sf::RenderTarget& target, const ClientMetrics& metrics) {
+        if (!m_visible) return;
+        
+        const auto start = NetClock::now();
+        if (start >= m_nextRefresh) {
+            rebuild(metrics);
+            m_nextRefresh = start + std::chrono::milliseconds(REFRESH_MS);
+        }
+        target.draw(m_bars);
+        for (const auto& text : m_rows) {
+            target.draw(text);
+        }
+        
+        const float costUs = std::chrono::duration<float, std::micro>(NetClock::now() - start).count();
+        m_costUs += (costUs - m_costUs) / 16.f;
+    }
+    
+private:
+    static constexpr size_t ROWS = 5;  // histogram rows; the counters row follows them
+    static constexpr unsigned CHARACTER_SIZE = 12;
+    static constexpr float PANEL_X = 8.f;
+    static constexpr float PANEL_Y = 8.f;
+    static constexpr float PADDING = 6.f;
+    static constexpr float ROW_HEIGHT = 18.f;
+    static constexpr float TEXT_WIDTH = 380.f;
+    static constexpr float BAR_WIDTH = 3.f;  // plus a 1px gap
+    static constexpr float PANEL_WIDTH = TEXT_WIDTH + RollingHistogram::BUCKETS * (BAR_WIDTH + 1.f) + 2.f * PADDING;
+    static constexpr float PANEL_HEIGHT = (ROWS + 1) * ROW_HEIGHT + 2.f * PADDING;
+    static constexpr size_t VERTICES_PER_QUAD = 6;
+    static constexpr std::array<const char*, 3> FONT_PATHS{
+        "C:/Windows/Fonts/consola.ttf",
+        "C:/Windows/Fonts/arial.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf"
+    };
+    
+    struct Row {
+        const char* label;
+        const RollingHistogram* histogram;
+        const char* unit;
+    };
+    
+    sf::Font m_font;
+    bool m_fontLoaded{false};
+    bool m_visible{false};
+    std::vector<sf::Text> m_rows;
+    sf::VertexArray m_bars{sf::PrimitiveType::Triangles};
+    size_t m_next{0};
+    NetClock::time_point m_nextRefresh{};
+    float m_costUs{0.f}; // running mean of draw()
+    
+    static float rowTop(size_t row) {
+        return PANEL_Y + PADDING + row * ROW_HEIGHT;
+    }
+    
+    void rebuild(const ClientMetrics& metrics) {
+        const std::array<Row, ROWS> rows{{
+            {"rtt",    &metrics.rttMs,        "ms"},
+            {"jitter", &metrics.jitterMs,     "ms"},
+            {"decode", &metrics.decodeUs,     "us"},
+            {"render", &metrics.renderMs,     "ms"},
+            {"ack",    &metrics.ackLatencyMs, "ms"},
+        }};
+        
+        m_bars.resize((1 + ROWS * RollingHistogram::BUCKETS) * VERTICES_PER_QUAD);
+        m_next = 0;
+        addQuad(PANEL_X, PANEL_Y, PANEL_WIDTH, PANEL_HEIGHT, sf::Color(0, 0, 0, 170));
+        
+        char line[128];
+        for (size_t r = 0; r < ROWS; ++r) {
+            const RollingHistogram& h = *rows[r].histogram;
+            
+            // Bars scaled to the fullest bucket; the open-ended last bucket stands out
+            std::uint32_t fullest = 1;
+            for (size_t b = 0; b < RollingHistogram::BUCKETS; ++b) {
+                fullest = std::max(fullest, h.bucket(b));
+            }
+            const float maxHeight = ROW_HEIGHT - 4.f;
+            const float bottom = rowTop(r) + ROW_HEIGHT - 2.f;
+            for (size_t b = 0; b < RollingHistogram::BUCKETS; ++b) {
+                const float height = maxHeight * h.bucket(b) / fullest;
+                const bool overflow = b + 1 == RollingHistogram::BUCKETS;
+                addQuad(PANEL_X + PADDING + TEXT_WIDTH + b * (BAR_WIDTH + 1.f), bottom - height,
+                        BAR_WIDTH, height, overflow ? sf::Color(255, 120, 60) : sf::Color(110, 200, 110));
+            }
             
-            for (size_t i = 0; i < p.body.size(); ++i) {
-                cell.setFillColor(i == 0 ? colors[p.id] : sf::Color(120, 120, 120));
-                cell.setPosition(sf::Vector2f(
-                    p.body[i].x * GRID_SIZE + 1.f,
-                    p.body[i].y * GRID_SIZE + 1.f
-                ));
-                window.draw(cell);
+            if (m_fontLoaded) {
+                std::snprintf(line, sizeof(line), "%-6s p50 %7.2f  p95 %7.2f  max %7.2f %s",
+                              rows[r].label, h.percentile(0.5f), h.percentile(0.95f), h.max(),
+                              rows[r].unit);
+                m_rows[r].setString(line);
             }
         }
         
-        window.display();
+        if (m_fontLoaded) {
+            std::snprintf(line, sizeof(line), "dropped %llu  held frames %llu  dirty cells %zu  hud %.1f us",
+                          static_cast<unsigned long long>(metrics.droppedSnapshots),
+                          static_cast<unsigned long long>(metrics.heldFrames), metrics.dirtyCells,
+                          m_costUs);
+            m_rows[ROWS].setString(line);
+        }
+    }
+    
+    void addQuad(float left, float top, float width, float height, sf::Color color) {
+        const float right = left + width;
+        const float bottom = top + height;
+        
+        sf::Vertex* v = &m_bars[m_next];
+        m_next += VERTICES_PER_QUAD;
+        
+        v[0].position = {left, top};
+        v[1].position = {right, top};
+        v[2].position = {left, bottom};
+        v[3].position = {left, bottom};
+        v[4].position = {right, top};
+        v[5].position = {right, bottom};
+        for (size_t i = 0; i < VERTICES_PER_QUAD; ++i) v[i].color = color;
     }
 };
 
@@ -407,6 +811,7 @@ int main(int argc, char* argv[]) {
         "Multiplayer Snake Client"
     );
     window.setFramerateLimit(60);
+    window.setKeyRepeatEnabled(false); // one KeyPressed per press
     
     NetworkClient client(serverHost, serverPort);
     
@@ -451,88 +856,119 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    GameState currentState;
+    Renderer renderer;
+    SnapshotInterpolator interpolator;
+    InputPredictor predictor;
+    ClientMetrics metrics;
+    Hud hud;
+    TokenBucket inputLimiter(INPUT_RATE_PER_SEC, INPUT_BURST);
+    std::array<Direction, MAX_PLAYERS> wantedInputs{};
     std::array<Direction, MAX_PLAYERS> lastInputs{};
+    wantedInputs.fill(Direction::Right);
     lastInputs.fill(Direction::Right);
-    sf::Clock inputClock;
+    sf::Clock stateClock; // time since the last snapshot
+    
+    // Send a player's wanted direction if it changed; held back (newest wins) while rate limited
+    auto sendInput = [&](int player) {
+        const Direction dir = wantedInputs[player];
+        if (dir == lastInputs[player]) return;
+        
+        const auto now = NetClock::now();
+        if (!inputLimiter.tryTake(now)) return;
+        
+        // Predicted locally right away; the server acks the seq later
+        std::uint32_t seq = predictor.record(player, dir, now);
+        if (client.postInput(player, dir, seq)) {
+            lastInputs[player] = dir;
+        } else {
+            predictor.cancel(player, seq);
+        }
+    };
     
     while (window.isOpen()) {
-        // Handle events
+        // Handle events; each direction change is sent as it happens
         while (auto e = window.pollEvent()) {
             if (e->is<sf::Event::Closed>()) {
                 window.close();
+            } else if (const auto* key = e->getIf<sf::Event::KeyPressed>();
+                       key && key->code == sf::Keyboard::Key::F3) {
+                hud.toggle();
+            } else if (auto input = InputAdapter::fromEvent(*e)) {
+                wantedInputs[input->player] = input->dir;
+                sendInput(input->player);
             }
         }
         
-        // Send input every 100ms to avoid flooding
-        if (inputClock.getElapsedTime().asMilliseconds() > 100) {
-            for (int player = 0; player < MAX_PLAYERS; ++player) {
-                auto newInput = InputAdapter::getInput(player); // player maps to joystick index
-                if (newInput && *newInput != lastInputs[player]) {
-                    client.sendInput(player, *newInput);
-                    lastInputs[player] = *newInput;
-                }
-            }
-            inputClock.restart();
+        // Retry changes the rate limit held back
+        for (int player = 0; player < MAX_PLAYERS; ++player) {
+            sendInput(player);
         }
         
-        // Receive game state
-        GameState newState = client.receiveState();
-        static int noStateTicks = 0;
-        
-        if (!newState.players.empty()) {
-            currentState = newState;
-            noStateTicks = 0; // Reset counter on successful receive
-        } else {
-            // Check if connection is still alive
-            // If we're not receiving state, connection may be lost
-            noStateTicks++;
-            if (noStateTicks > 100) { // ~1.6 seconds without state
-                // Connection lost - show error window
-                window.close();
-                
-                sf::RenderWindow errorWindow(
-                    sf::VideoMode({450, 150}),
-                    "Connection Lost"
-                );
-                
-                // Load system font for error message
-                sf::Font font;
-                bool fontLoaded = font.openFromFile("C:/Windows/Fonts/arial.ttf");
-                
-                // Create text only if font loaded
-                std::unique_ptr<sf::Text> errorText;
-                if (fontLoaded) {
-                    std::ostringstream msg;
-                    msg << "Server Disconnected\n\nConnection to " << serverHost << ":" << serverPort
-                        << " lost\n\nClose this window to exit";
-                    errorText = std::make_unique<sf::Text>(font);
-                    errorText->setString(msg.str());
-                    errorText->setCharacterSize(16);
-                    errorText->setFillColor(sf::Color::White);
-                    errorText->setPosition({20.f, 20.f});
-                }
-                
-                while (errorWindow.isOpen()) {
-                    while (const std::optional event = errorWindow.pollEvent()) {
-                        if (event->is<sf::Event::Closed>()) {
-                            errorWindow.close();
-                        }
-                    }
-                    
-                    errorWindow.clear(sf::Color(40, 40, 40));
-                    if (errorText) {
-                        errorWindow.draw(*errorText);
+        // Pick up the newest snapshot from the network thread (never blocks)
+        if (client.pollState()) {
+            interpolator.push(client.snapshot());
+            metrics.addSnapshot(client.snapshot());
+            predictor.reconcile(client.snapshot().state, NetClock::now(), &metrics.ackLatencyMs);
+            stateClock.restart();
+        } else if (!client.isConnected() ||
+                   stateClock.getElapsedTime().asMilliseconds() > STATE_TIMEOUT_MS) {
+            // Connection lost - show error window
+            window.close();
+            
+            sf::RenderWindow errorWindow(
+                sf::VideoMode({450, 150}),
+                "Connection Lost"
+            );
+            
+            // Load system font for error message
+            sf::Font font;
+            bool fontLoaded = font.openFromFile("C:/Windows/Fonts/arial.ttf");
+            
+            // Create text only if font loaded
+            std::unique_ptr<sf::Text> errorText;
+            if (fontLoaded) {
+                std::ostringstream msg;
+                msg << "Server Disconnected\n\nConnection to " << serverHost << ":" << serverPort
+                    << " lost\n\nClose this window to exit";
+                errorText = std::make_unique<sf::Text>(font);
+                errorText->setString(msg.str());
+                errorText->setCharacterSize(16);
+                errorText->setFillColor(sf::Color::White);
+                errorText->setPosition({20.f, 20.f});
+            }
+            
+            while (errorWindow.isOpen()) {
+                while (const std::optional event = errorWindow.pollEvent()) {
+                    if (event->is<sf::Event::Closed>()) {
+                        errorWindow.close();
                     }
-                    errorWindow.display();
                 }
                 
-                break; // Exit game loop
+                errorWindow.clear(sf::Color(40, 40, 40));
+                if (errorText) {
+                    errorWindow.draw(*errorText);
+                }
+                errorWindow.display();
             }
+            
+            break; // Exit game loop
+        }
+        
+        float rttMs;
+        while (client.pollRtt(rttMs)) {
+            metrics.rttMs.add(rttMs);
         }
         
-        // Render
-        Renderer::drawState(window, currentState);
+        // Render; the board's CPU cost is measured without the HUD and display()
+        const auto renderStart = NetClock::now();
+        const InterpolatedFrame frame = interpolator.sample(renderStart);
+        if (frame.from == frame.to) ++metrics.heldFrames;
+        renderer.drawState(window, frame, predictor);
+        metrics.renderMs.add(std::chrono::duration<float, std::milli>(NetClock::now() - renderStart).count());
+        metrics.dirtyCells = renderer.lastDirtyCells();
+        
+        hud.draw(window, metrics);
+        window.display();
     }
     
     client.disconnect();
@@ -0,0 +1,271 @@
+// Display-less snake client for soak tests and CI: connects like the SFML
+// client, steers one player from a script or a random policy and logs one
+// CSV line per snapshot (decode time, arrival jitter, hash check).
+
+#include "NetworkClient.h"
+#include "StateHash.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Protocol::Direction;
+
+namespace {
+
+constexpr int POLL_MS = 1;             // main loop sleep between snapshot polls
+constexpr int RANDOM_TURN_MS = 300;    // random policy: one turn this often
+constexpr int STATE_TIMEOUT_MS = 2000; // no snapshot for this long = connection lost
+
+// Exit codes
+constexpr int EXIT_OK = 0;
+constexpr int EXIT_DESYNC = 1;         // at least one snapshot failed its hash check
+constexpr int EXIT_CONNECTION = 2;     // could not connect, or lost the server early
+constexpr int EXIT_USAGE = 3;
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 8765;
+    int player = 0;
+    double durationSeconds = 60.0;
+    unsigned seed = 1;
+    std::string scriptPath;     // empty: random policy
+    bool quiet = false;         // summary only, no per-snapshot lines
+    bool jsonLines = false;     // stay on JSON lines instead of binary frames
+};
+
+/// One scripted step: wait delayMs, then turn
+struct ScriptStep {
+    int delayMs;
+    Direction dir;
+};
+
+void printUsage() {
+    std::cerr << "Usage: snake_headless [host] [port] [--player N] [--duration SECONDS]\n"
+                 "                      [--seed N] [--script FILE] [--quiet] [--json-lines]\n"
+                 "Script lines: <delay_ms> <up|down|left|right>, '#' starts a comment;\n"
+                 "the script loops. Without --script a seeded random policy turns every "
+              << RANDOM_TURN_MS << " ms.\n";
+}
+
+bool parseDirection(const std::string& word, Direction& dir) {
+    if (word == "up")    { dir = Direction::Up;    return true; }
+    if (word == "down")  { dir = Direction::Down;  return true; }
+    if (word == "left")  { dir = Direction::Left;  return true; }
+    if (word == "right") { dir = Direction::Right; return true; }
+    return false;
+}
+
+bool loadScript(const std::string& path, std::vector<ScriptStep>& steps) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Cannot open script " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        ScriptStep step;
+        std::string word;
+        if (!(fields >> step.delayMs)) continue; // blank or comment line
+        if (step.delayMs < 0 || !(fields >> word) || !parseDirection(word, step.dir)) {
+            std::cerr << path << ":" << lineNumber << ": expected <delay_ms> <up|down|left|right>"
+                      << std::endl;
+            return false;
+        }
+        steps.push_back(step);
+    }
+    if (steps.empty()) {
+        std::cerr << "Script " << path << " has no steps" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    int positional = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--player" && hasValue) {
+            options.player = std::atoi(argv[++i]);
+        } else if (arg == "--duration" && hasValue) {
+            options.durationSeconds = std::atof(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--script" && hasValue) {
+            options.scriptPath = argv[++i];
+        } else if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "--json-lines") {
+            options.jsonLines = true;
+        } else if (arg.rfind("--", 0) != 0 && positional == 0) {
+            options.host = arg;
+            ++positional;
+        } else if (arg.rfind("--", 0) != 0 && positional == 1) {
+            options.port = std::atoi(arg.c_str());
+            ++positional;
+        } else {
+            return false;
+        }
+    }
+    return options.port > 0 && options.player >= 0 && options.durationSeconds > 0.0;
+}
+
+/// Running statistics over the snapshots seen
+struct Stats {
+    std::uint64_t snapshots{0};
+    std::uint64_t skipped{0};       // stale snapshots the network thread never decoded
+    std::uint64_t desyncs{0};
+    double decodeTotalUs{0.0};
+    float decodeMaxUs{0.f};
+    float intervalMs{0.f};          // running mean inter-arrival time
+    float jitterMs{0.f};            // running mean deviation from it
+    float intervalMaxMs{0.f};
+    std::uint64_t rttSamples{0};
+    double rttTotalMs{0.0};
+    float rttMaxMs{0.f};
+};
+
+float millisBetween(NetClock::time_point from, NetClock::time_point to) {
+    return std::chrono::duration<float, std::milli>(to - from).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return EXIT_USAGE;
+    }
+
+    std::vector<ScriptStep> script;
+    if (!options.scriptPath.empty() && !loadScript(options.scriptPath, script)) {
+        return EXIT_USAGE;
+    }
+
+    NetworkClient client(options.host, options.port, !options.jsonLines);
+    if (!client.connect()) {
+        return EXIT_CONNECTION;
+    }
+
+    std::mt19937 rng(options.seed);
+    size_t scriptIndex = 0;
+    Direction lastDir = Direction::Right;
+
+    const auto start = NetClock::now();
+    const auto end = start + std::chrono::duration_cast<NetClock::duration>(
+        std::chrono::duration<double>(options.durationSeconds));
+    auto nextInput = start + std::chrono::milliseconds(script.empty() ? RANDOM_TURN_MS
+                                                                      : script[0].delayMs);
+    auto lastSnapshot = start;
+    NetClock::time_point previousArrival;
+    std::uint64_t previousReceived = 0;
+    Stats stats;
+    bool lost = false;
+
+    if (!options.quiet) {
+        std::cout << "received,t_ms,interval_ms,jitter_ms,decode_us,players,hash" << std::endl;
+    }
+
+    while (true) {
+        const auto now = NetClock::now();
+        if (now >= end) break;
+
+        // Input policy
+        if (now >= nextInput) {
+            Direction dir;
+            int delayMs;
+            if (script.empty()) {
+                // Random turn, never a reversal (the server would ignore it)
+                do {
+                    dir = static_cast<Direction>(rng() % 4);
+                } while ((static_cast<int>(dir) ^ static_cast<int>(lastDir)) == 1);
+                delayMs = RANDOM_TURN_MS;
+            } else {
+                dir = script[scriptIndex].dir;
+                scriptIndex = (scriptIndex + 1) % script.size();
+                delayMs = script[scriptIndex].delayMs;
+            }
+            client.postInput(options.player, dir, 0);
+            lastDir = dir;
+            nextInput = now + std::chrono::milliseconds(delayMs);
+        }
+
+        // Snapshot log
+        if (client.pollState()) {
+            const Snapshot& snapshot = client.snapshot();
+            const bool hashOk = StateHash::compute(snapshot.state) == snapshot.state.hash;
+
+            float interval = 0.f;
+            if (stats.snapshots > 0) {
+                interval = millisBetween(previousArrival, snapshot.receivedAt);
+                if (stats.snapshots == 1) stats.intervalMs = interval;
+                stats.jitterMs += (std::abs(interval - stats.intervalMs) - stats.jitterMs) / 16.f;
+                stats.intervalMs += (interval - stats.intervalMs) / 16.f;
+                stats.intervalMaxMs = std::max(stats.intervalMaxMs, interval);
+            }
+            stats.skipped += snapshot.received - previousReceived - 1;
+            stats.desyncs += hashOk ? 0 : 1;
+            stats.decodeTotalUs += snapshot.decodeMicros;
+            stats.decodeMaxUs = std::max(stats.decodeMaxUs, snapshot.decodeMicros);
+            ++stats.snapshots;
+
+            if (!options.quiet) {
+                std::printf("%llu,%.1f,%.2f,%.2f,%.1f,%zu,%s\n",
+                            static_cast<unsigned long long>(snapshot.received),
+                            millisBetween(start, snapshot.receivedAt), interval, stats.jitterMs,
+                            snapshot.decodeMicros, snapshot.state.players.size(),
+                            hashOk ? "ok" : "DESYNC");
+            }
+
+            previousArrival = snapshot.receivedAt;
+            previousReceived = snapshot.received;
+            lastSnapshot = now;
+        } else if (!client.isConnected() || millisBetween(lastSnapshot, now) > STATE_TIMEOUT_MS) {
+            lost = true;
+            break;
+        }
+
+        float rttMs;
+        while (client.pollRtt(rttMs)) {
+            ++stats.rttSamples;
+            stats.rttTotalMs += rttMs;
+            stats.rttMaxMs = std::max(stats.rttMaxMs, rttMs);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_MS));
+    }
+
+    std::fflush(stdout);
+    std::cerr << "snapshots=" << stats.snapshots
+              << " skipped=" << stats.skipped
+              << " desyncs=" << stats.desyncs
+              << " decode_us(mean/max)=" << (stats.snapshots ? stats.decodeTotalUs / stats.snapshots : 0.0)
+              << "/" << stats.decodeMaxUs
+              << " interval_ms(mean/max)=" << stats.intervalMs << "/" << stats.intervalMaxMs
+              << " jitter_ms=" << stats.jitterMs
+              << " rtt_ms(mean/max)=" << (stats.rttSamples ? stats.rttTotalMs / stats.rttSamples : 0.0)
+              << "/" << stats.rttMaxMs
+              << (lost ? " connection=lost" : " connection=ok") << std::endl;
+
+    client.disconnect();
+    if (stats.desyncs > 0) return EXIT_DESYNC;
+    if (lost) return EXIT_CONNECTION;
+    return EXIT_OK;
+}
@@ -0,0 +1,176 @@
+#include "Logger.h"
+#include <QByteArray>
+#include <QDebug>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+
+namespace {
+
+const char* categoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::WebSocket: return "websocket";
+        case LogCategory::Input:     return "input";
+        case LogCategory::ViGEm:     return "vigem";
+        default:                     return "general";
+    }
+}
+
+} // namespace
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : m_level(static_cast<int>(LogLevel::Info))
+{
+    for (size_t i = 0; i < RING_SIZE; ++i) {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    
+    // Limites par défaut : de quoi suivre une connexion, pas un flux analogique à 60 Hz
+    setRateLimit(LogCategory::WebSocket, 20);
+    setRateLimit(LogCategory::Input, 20);
+    setRateLimit(LogCategory::ViGEm, 5);
+    
+    const QByteArray env = qgetenv("VC_LOG_LEVEL").toLower();
+    if (env == "debug") setLevel(LogLevel::Debug);
+    else if (env == "info") setLevel(LogLevel::Info);
+    else if (env == "warning") setLevel(LogLevel::Warning);
+    else if (env == "error") setLevel(LogLevel::Error);
+    else if (env == "off") setLevel(LogLevel::Off);
+    
+    m_writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    m_running.store(false);
+    m_wake.notify_one();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
+
+void Logger::setRateLimit(LogCategory category, std::uint32_t maxPerSecond) {
+    m_limits[static_cast<size_t>(category)].maxPerSecond.store(maxPerSecond, std::memory_order_relaxed);
+}
+
+bool Logger::allow(LogCategory category) {
+    RateLimit& limit = m_limits[static_cast<size_t>(category)];
+    const std::uint32_t maxPerSecond = limit.maxPerSecond.load(std::memory_order_relaxed);
+    if (maxPerSecond == 0) return true;
+    
+    // Le premier qui voit la fenêtre expirée la redémarre
+    const qint64 now = nowMs();
+    qint64 start = limit.windowStartMs.load(std::memory_order_relaxed);
+    if (now - start >= 1000 &&
+        limit.windowStartMs.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        limit.count.store(0, std::memory_order_relaxed);
+    }
+    
+    if (limit.count.fetch_add(1, std::memory_order_relaxed) < maxPerSecond) return true;
+    limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Logger::log(LogLevel level, LogCategory category, const char* format, ...) {
+    if (!isEnabled(level) || !allow(category)) return;
+    
+    // Réserver une entrée ; ring plein = message perdu plutôt que d'attendre
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Entry* entry;
+    while (true) {
+        entry = &m_ring[pos & (RING_SIZE - 1)];
+        const size_t sequence = entry->sequence.load(std::memory_order_acquire);
+        if (sequence == pos) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (sequence < pos) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    
+    entry->level = level;
+    entry->category = category;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(entry->text, MESSAGE_SIZE, format, args);
+    va_end(args);
+    entry->sequence.store(pos + 1, std::memory_order_release);
+    
+    // Debug et info partent au prochain réveil périodique du thread d'écriture
+    if (level >= LogLevel::Warning) {
+        m_wake.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    qint64 lastReport = nowMs();
+    while (true) {
+        while (writeOne()) {}
+        
+        const qint64 now = nowMs();
+        if (now - lastReport >= 1000) {
+            reportSuppressed();
+            lastReport = now;
+        }
+        
+        if (!m_running.load()) break;
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_for(lock, std::chrono::milliseconds(WRITER_WAKEUP_MS));
+    }
+    
+    // Arrêt : vider ce qui reste
+    while (writeOne()) {}
+    reportSuppressed();
+}
+
+bool Logger::writeOne() {
+    const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Entry& entry = m_ring[pos & (RING_SIZE - 1)];
+    if (entry.sequence.load(std::memory_order_acquire) != pos + 1) return false;
+    
+    output(entry.level, entry.category, entry.text);
+    entry.sequence.store(pos + RING_SIZE, std::memory_order_release);
+    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+void Logger::reportSuppressed() {
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        RateLimit& limit = m_limits[i];
+        const std::uint32_t suppressed = limit.suppressed.exchange(0, std::memory_order_relaxed);
+        if (suppressed == 0) continue;
+        
+        char text[MESSAGE_SIZE];
+        std::snprintf(text, sizeof(text), "%u messages supprimés (limite %u/s)",
+                      suppressed, limit.maxPerSecond.load(std::memory_order_relaxed));
+        output(LogLevel::Warning, static_cast<LogCategory>(i), text);
+    }
+    
+    const std::uint32_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        char text[MESSAGE_SIZE];
+        std::snprintf(text, sizeof(text), "%u messages perdus (file pleine)", dropped);
+        output(LogLevel::Warning, LogCategory::General, text);
+    }
+}
+
+void Logger::output(LogLevel level, LogCategory category, const char* text) {
+    QMessageLogger logger;
+    switch (level) {
+        case LogLevel::Debug:   logger.debug("[%s] %s", categoryName(category), text); break;
+        case LogLevel::Info:    logger.info("[%s] %s", categoryName(category), text); break;
+        case LogLevel::Warning: logger.warning("[%s] %s", categoryName(category), text); break;
+        default:                logger.critical("[%s] %s", categoryName(category), text); break;
+    }
+}
+
+qint64 Logger::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,145 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief Niveaux de log, du plus bavard au plus grave
+ */
+enum class LogLevel : int {
+    Debug = 0,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+/**
+ * @brief Catégories de log, chacune avec sa propre limite de débit
+ */
+enum class LogCategory : int {
+    General = 0,
+    WebSocket,
+    Input,
+    ViGEm,
+    Count
+};
+
+/**
+ * @brief Journal asynchrone pour les chemins critiques (inputs, WebSocket)
+ *
+ * Les messages sont formatés dans une entrée d'un ring buffer lock-free
+ * (plusieurs producteurs, un consommateur) ; un thread d'écriture les
+ * transmet ensuite à la sortie de messages de Qt. Le thread appelant ne
+ * fait donc jamais d'I/O console et ne bloque jamais : si le ring est
+ * plein, le message est perdu et compté.
+ *
+ * Le niveau minimal se règle à l'exécution (setLevel(), ou la variable
+ * d'environnement VC_LOG_LEVEL : debug, info, warning, error, off).
+ * Chaque catégorie est limitée à un nombre de messages par seconde ; les
+ * messages supprimés sont résumés une fois par seconde.
+ *
+ * Utiliser les macros VC_LOG_* : les arguments ne sont évalués que si le
+ * niveau est actif.
+ */
+class Logger {
+public:
+    static constexpr size_t RING_SIZE = 1024;       // puissance de 2
+    static constexpr size_t MESSAGE_SIZE = 240;     // tronqué au-delà
+    static constexpr int WRITER_WAKEUP_MS = 50;     // attente max du thread d'écriture
+    
+    /**
+     * @brief Instance unique ; le thread d'écriture démarre au premier appel
+     */
+    static Logger& instance();
+    
+    ~Logger();
+    
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    
+    void setLevel(LogLevel level) { m_level.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(m_level.load(std::memory_order_relaxed)); }
+    
+    /**
+     * @brief Vrai si un message de ce niveau serait écrit (une lecture atomique)
+     */
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= m_level.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Limite une catégorie à maxPerSecond messages (0 : sans limite)
+     */
+    void setRateLimit(LogCategory category, std::uint32_t maxPerSecond);
+    
+    /**
+     * @brief Formate (printf) et met en file un message ; ne bloque jamais
+     */
+    void log(LogLevel level, LogCategory category, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((format(printf, 4, 5)))
+#endif
+        ;
+    
+private:
+    Logger();
+    
+    struct Entry {
+        std::atomic<size_t> sequence;
+        LogLevel level;
+        LogCategory category;
+        char text[MESSAGE_SIZE];
+    };
+    
+    // Fenêtre d'une seconde par catégorie, sans verrou
+    struct RateLimit {
+        std::atomic<std::uint32_t> maxPerSecond{0};
+        std::atomic<qint64> windowStartMs{0};
+        std::atomic<std::uint32_t> count{0};
+        std::atomic<std::uint32_t> suppressed{0};
+    };
+    
+    static constexpr size_t CATEGORY_COUNT = static_cast<size_t>(LogCategory::Count);
+    
+    std::atomic<int> m_level;
+    std::array<RateLimit, CATEGORY_COUNT> m_limits;
+    
+    // Ring borné (Vyukov) : chaque entrée porte son numéro de séquence
+    std::array<Entry, RING_SIZE> m_ring;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) std::atomic<size_t> m_dequeuePos{0};
+    std::atomic<std::uint32_t> m_dropped{0};    // ring plein
+    
+    std::thread m_writer;
+    std::atomic<bool> m_running{true};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    
+    bool allow(LogCategory category);
+    void writerLoop();
+    bool writeOne();
+    void reportSuppressed();
+    static void output(LogLevel level, LogCategory category, const char* text);
+    static qint64 nowMs();
+};
+
+#define VC_LOG(level, category, ...) \
+    do { \
+        if (Logger::instance().isEnabled(level)) \
+            Logger::instance().log(level, category, __VA_ARGS__); \
+    } while (0)
+
+#define VC_LOG_DEBUG(category, ...)   VC_LOG(LogLevel::Debug, category, __VA_ARGS__)
+#define VC_LOG_INFO(category, ...)    VC_LOG(LogLevel::Info, category, __VA_ARGS__)
+#define VC_LOG_WARNING(category, ...) VC_LOG(LogLevel::Warning, category, __VA_ARGS__)
+#define VC_LOG_ERROR(category, ...)   VC_LOG(LogLevel::Error, category, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -5,11 +5,15 @@
 #include <QMessageBox>
 #include <cstdlib>
 #include "MainWindow.h"
+#include "Logger.h"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
     QApplication::setQuitOnLastWindowClosed(true);
     
+    // Démarre le thread d'écriture des logs avant les premiers inputs
+    Logger::instance();
+    
     // When quit is requested, forcefully exit after brief cleanup
     QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
         std::exit(0);
@@ -1,4 +1,5 @@
 #include "LocalInputSource.h"
+#include "Logger.h"
 #include <QDebug>
 #include <windows.h>
 #include <ViGEm/Client.h>
@@ -73,7 +74,8 @@ void LocalInputSource::setAnalogStick(short x, short y) {
 }
 
 void LocalInputSource::onButtonPressed(const QString& buttonName) {
-    qDebug() << "Controller" << m_controllerId << "button pressed:" << buttonName;
+    VC_LOG_DEBUG(LogCategory::Input, "Controller %d button pressed: %s", m_controllerId,
+                 qUtf8Printable(buttonName));
     
     // Add to pressed buttons set
     m_pressedButtons.insert(buttonName);
@@ -111,7 +113,8 @@ void LocalInputSource::onButtonPressed(const QString& buttonName) {
 }
 
 void LocalInputSource::onButtonReleased(const QString& buttonName) {
-    qDebug() << "Controller" << m_controllerId << "button released:" << buttonName;
+    VC_LOG_DEBUG(LogCategory::Input, "Controller %d button released: %s", m_controllerId,
+                 qUtf8Printable(buttonName));
     
     // Remove from pressed buttons set
     m_pressedButtons.remove(buttonName);
@@ -43,6 +43,18 @@ struct ControllerState {
         leftStickX = leftStickY = rightStickX = rightStickY = 0;
         leftTrigger = rightTrigger = 0;
     }
+    
+    bool operator==(const ControllerState& other) const {
+        return buttons == other.buttons &&
+               dpadUp == other.dpadUp && dpadDown == other.dpadDown &&
+               dpadLeft == other.dpadLeft && dpadRight == other.dpadRight &&
+               leftStickX == other.leftStickX && leftStickY == other.leftStickY &&
+               rightStickX == other.rightStickX && rightStickY == other.rightStickY &&
+               leftTrigger == other.leftTrigger && rightTrigger == other.rightTrigger &&
+               controllerId == other.controllerId;
+    }
+    
+    bool operator!=(const ControllerState& other) const { return !(*this == other); }
 };
 
 /**
@@ -1,4 +1,5 @@
 #include "MultiControllerManager.h"
+#include "Logger.h"
 #include <QDebug>
 #include <QThread>
 #include <cstring>
@@ -160,8 +161,8 @@ void MultiControllerManager::updateController(int controllerId, const Controller
     
     VIGEM_ERROR result = vigem_target_x360_update(m_client, controller->target, controller->report);
     if (!VIGEM_SUCCESS(result)) {
-        qWarning() << "Failed to update controller" << controllerId 
-                   << "state. Error code:" << result;
+        VC_LOG_WARNING(LogCategory::ViGEm, "Failed to update controller %d state. Error code: %d",
+                       controllerId, static_cast<int>(result));
     }
 }
 
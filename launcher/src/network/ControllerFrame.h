@@ -0,0 +1,82 @@
+#ifndef CONTROLLERFRAME_H
+#define CONTROLLERFRAME_H
+
+#include "IInputSource.h"
+#include <QtGlobal>
+
+/**
+ * @brief Message WebSocket binaire portant l'état complet d'une manette
+ *
+ * Envoyé par l'application mobile à la place du JSON une fois que le
+ * launcher a annoncé le format dans son message hello. Taille fixe,
+ * entiers little endian :
+ *
+ *   offset 0   u8   version       VERSION
+ *          1   u8   flags         réservé, 0
+ *          2   u16  buttons       bitmask XUSB (D-Pad compris)
+ *          4   i16  leftStickX    -32768..32767
+ *          6   i16  leftStickY
+ *          8   i16  rightStickX
+ *         10   i16  rightStickY
+ *         12   u8   leftTrigger   0..255
+ *         13   u8   rightTrigger
+ *         14   u32  seq           incrémenté à chaque envoi
+ *         18   u32  timestampMs   horloge de l'émetteur, modulo 2^32
+ *
+ * Le décodage lit des offsets fixes, sans allocation ni copie.
+ */
+namespace ControllerFrame {
+
+constexpr quint8 VERSION = 1;
+constexpr int SIZE = 22;
+
+/**
+ * @brief Message texte envoyé par le launcher à chaque nouveau client
+ */
+constexpr const char* HELLO = "{\"type\":\"hello\",\"binaryVersion\":1}";
+
+namespace detail {
+
+inline quint16 readU16(const unsigned char* in) {
+    return static_cast<quint16>(in[0] | (in[1] << 8));
+}
+
+inline quint32 readU32(const unsigned char* in) {
+    return static_cast<quint32>(in[0]) |
+           (static_cast<quint32>(in[1]) << 8) |
+           (static_cast<quint32>(in[2]) << 16) |
+           (static_cast<quint32>(in[3]) << 24);
+}
+
+} // namespace detail
+
+/**
+ * @brief Décode un message dans state (controllerId inchangé)
+ * @return false si la taille ou la version ne correspondent pas
+ */
+inline bool decode(const char* data, qsizetype size, ControllerState& state,
+                   quint32& seq, quint32& timestampMs) {
+    const auto* in = reinterpret_cast<const unsigned char*>(data);
+    if (size != SIZE || in[0] != VERSION) return false;
+
+    state.buttons = detail::readU16(in + 2);
+    state.leftStickX = static_cast<short>(detail::readU16(in + 4));
+    state.leftStickY = static_cast<short>(detail::readU16(in + 6));
+    state.rightStickX = static_cast<short>(detail::readU16(in + 8));
+    state.rightStickY = static_cast<short>(detail::readU16(in + 10));
+    state.leftTrigger = in[12];
+    state.rightTrigger = in[13];
+    seq = detail::readU32(in + 14);
+    timestampMs = detail::readU32(in + 18);
+
+    // Les flags D-Pad suivent le bitmask (bits XUSB 0x0001..0x0008)
+    state.dpadUp = (state.buttons & 0x0001) != 0;
+    state.dpadDown = (state.buttons & 0x0002) != 0;
+    state.dpadLeft = (state.buttons & 0x0004) != 0;
+    state.dpadRight = (state.buttons & 0x0008) != 0;
+    return true;
+}
+
+} // namespace ControllerFrame
+
+#endif // CONTROLLERFRAME_H
@@ -1,10 +1,11 @@
 #include "WebSocketInputSource.h"
+#include "ControllerFrame.h"
+#include "Logger.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QNetworkInterface>
 #include <QDebug>
 #include <QtMath>
-#include <iostream>
 
 // Définition des constantes XUSB_BUTTON
 #define XUSB_GAMEPAD_DPAD_UP            0x0001
@@ -40,17 +41,51 @@ const QMap<QString, unsigned short> WebSocketInputSource::ButtonMap = {
     {"DPAD_RIGHT", XUSB_GAMEPAD_DPAD_RIGHT}
 };
 
+// Bits d'appui au-delà des 16 boutons XUSB : les gâchettes LT/RT
+#define EDGE_LEFT_TRIGGER               0x10000u
+#define EDGE_RIGHT_TRIGGER              0x20000u
+
+/**
+ * @brief Boutons et gâchettes sous forme de bits appuyé/relâché
+ *
+ * Le mobile envoie LT/RT en tout ou rien (0 ou 255) ; une gâchette compte
+ * comme appuyée dès qu'elle n'est plus à 0.
+ */
+static quint32 pressedBits(const ControllerState& state) {
+    return state.buttons |
+           (state.leftTrigger != 0 ? EDGE_LEFT_TRIGGER : 0u) |
+           (state.rightTrigger != 0 ? EDGE_RIGHT_TRIGGER : 0u);
+}
+
 WebSocketInputSource::WebSocketInputSource(int controllerId, QObject* parent)
     : IInputSource(parent)
     , m_server(nullptr)
     , m_port(8765)
     , m_isActive(false)
+    , m_outputTimer(new QTimer(this))
+    , m_outputRateHz(0)
 {
     m_currentState.controllerId = controllerId;
+    m_lastEmitted = m_currentState;
+    
+    m_outputTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_outputTimer, &QTimer::timeout, this, &WebSocketInputSource::onOutputTimer);
+    setOutputRate(DEFAULT_OUTPUT_RATE_HZ);
+}
+
+void WebSocketInputSource::setOutputRate(int hz) {
+    m_outputRateHz = qMax(0, hz);
+    if (m_outputRateHz > 0) {
+        // Arrondi à la milliseconde : 250 Hz -> 4 ms, 1000 Hz -> 1 ms
+        m_outputTimer->setInterval(qMax(1, 1000 / m_outputRateHz));
+    } else {
+        m_outputTimer->stop();
+        flushState();
+    }
 }
 
 void WebSocketInputSource::DebugPrintReceivedMessage(const QString& message) {
-    std::cout << "Received Message: " << message.toStdString() << std::endl;
+    VC_LOG_DEBUG(LogCategory::WebSocket, "Message reçu: %s", qUtf8Printable(message));
 }
 
 WebSocketInputSource::~WebSocketInputSource() {
@@ -112,7 +147,9 @@ void WebSocketInputSource::stop() {
     }
     
     m_isActive = false;
+    m_outputTimer->stop();
     m_currentState.reset();
+    m_lastEmitted = m_currentState;
     
     qInfo() << "STOP Serveur WebSocket arrêté";
     emit connectionStatusChanged(false);
@@ -152,39 +189,97 @@ void WebSocketInputSource::onNewConnection() {
     
     connect(client, &QWebSocket::textMessageReceived,
             this, &WebSocketInputSource::onTextMessageReceived);
+    connect(client, &QWebSocket::binaryMessageReceived,
+            this, &WebSocketInputSource::onBinaryMessageReceived);
     connect(client, &QWebSocket::disconnected,
             this, &WebSocketInputSource::onClientDisconnected);
 
+    // Annonce du format binaire ; un client qui ne le connaît pas reste en JSON
+    client->sendTextMessage(QString::fromLatin1(ControllerFrame::HELLO));
+
     // Emit signal to notify UI that a client has connected
     emit connectionStatusChanged(true);
-    
-    std::cout << "New client connected." << std::endl;
 }
 
 void WebSocketInputSource::onTextMessageReceived(const QString& message) {
     QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
     if (!doc.isObject()) {
-        qWarning() << "Warning:  Message JSON invalide";
+        VC_LOG_WARNING(LogCategory::WebSocket, "Message JSON invalide");
         return;
     }
     
     QJsonObject obj = doc.object();
     QString type = obj["type"].toString();
+    ControllerState next = m_currentState;
     
     if (type == "button") {
-        processButtonEvent(obj);
-        std::cout << "Processed button event." << std::endl;
-        DebugPrintReceivedMessage(message); //debug print, remove in production
+        processButtonEvent(obj, next);
+        DebugPrintReceivedMessage(message);
     } else if (type == "analog") {
-        processAnalogEvent(obj);
-        std::cout << "Processed analog event." << std::endl;
-        DebugPrintReceivedMessage(message); //debug print, remove in production
+        processAnalogEvent(obj, next);
+        DebugPrintReceivedMessage(message);
     } else {
-        qDebug() << "Type de message inconnu:" << type;
+        VC_LOG_DEBUG(LogCategory::WebSocket, "Type de message inconnu: %s", qUtf8Printable(type));
+        return;
+    }
+    
+    applyState(next);
+}
+
+void WebSocketInputSource::onBinaryMessageReceived(const QByteArray& message) {
+    // État complet décodé à offsets fixes, sans passer par QJsonDocument
+    quint32 seq = 0;
+    quint32 timestampMs = 0;
+    ControllerState next = m_currentState;
+    if (!ControllerFrame::decode(message.constData(), message.size(), next, seq, timestampMs)) {
+        VC_LOG_WARNING(LogCategory::WebSocket, "Message binaire invalide (%d octets, version %d)",
+                       static_cast<int>(message.size()),
+                       message.isEmpty() ? -1 : static_cast<int>(static_cast<quint8>(message[0])));
+        return;
+    }
+    
+    VC_LOG_DEBUG(LogCategory::WebSocket, "Frame %u (t=%u ms): boutons=0x%04x gauche=(%d,%d) droite=(%d,%d)",
+                 seq, timestampMs, next.buttons,
+                 next.leftStickX, next.leftStickY, next.rightStickX, next.rightStickY);
+    
+    applyState(next);
+}
+
+void WebSocketInputSource::applyState(const ControllerState& next) {
+    // Un bouton ou une gâchette dont le dernier changement n'est pas encore
+    // parti : émettre l'état intermédiaire d'abord, sinon appui + relâchement
+    // s'annuleraient
+    const quint32 current = pressedBits(m_currentState);
+    const quint32 toggled = pressedBits(next) ^ current;
+    const quint32 unsent = current ^ pressedBits(m_lastEmitted);
+    if (toggled & unsent) {
+        flushState();
     }
     
-    // Émettre le changement d'état
+    m_currentState = next;
+    if (m_outputRateHz == 0) {
+        flushState();
+    } else if (!m_outputTimer->isActive()) {
+        // Temps calme : partir tout de suite, puis regrouper jusqu'au tick
+        flushState();
+        m_outputTimer->start();
+    }
+}
+
+bool WebSocketInputSource::flushState() {
+    if (m_currentState == m_lastEmitted) {
+        return false;
+    }
+    m_lastEmitted = m_currentState;
     emit stateChanged(m_currentState);
+    return true;
+}
+
+void WebSocketInputSource::onOutputTimer() {
+    // Rien de neuf pendant une période entière : arrêter jusqu'au prochain changement
+    if (!flushState()) {
+        m_outputTimer->stop();
+    }
 }
 
 void WebSocketInputSource::onClientDisconnected() {
@@ -198,8 +293,9 @@ void WebSocketInputSource::onClientDisconnected() {
         
         // Réinitialiser l'état si plus de clients
         if (m_clients.isEmpty()) {
-            m_currentState.reset();
-            emit stateChanged(m_currentState);
+            ControllerState released = m_currentState;
+            released.reset();
+            applyState(released);
             
             // Emit signal to notify UI that all clients have disconnected
             emit connectionStatusChanged(false);
@@ -207,54 +303,52 @@ void WebSocketInputSource::onClientDisconnected() {
     }
 }
 
-void WebSocketInputSource::processButtonEvent(const QJsonObject& data) {
+void WebSocketInputSource::processButtonEvent(const QJsonObject& data, ControllerState& state) {
     QString button = data["button"].toString();
     bool pressed = data["pressed"].toBool();
     
-    qDebug() << "Bouton:" << button << (pressed ? "PRESSED" : "RELEASED");
+    VC_LOG_DEBUG(LogCategory::Input, "Bouton: %s %s", qUtf8Printable(button),
+                 pressed ? "PRESSED" : "RELEASED");
     
-    updateButtonBitmask(button, pressed);
+    updateButtonBitmask(button, pressed, state);
 }
 
-void WebSocketInputSource::processAnalogEvent(const QJsonObject& data) {
+void WebSocketInputSource::processAnalogEvent(const QJsonObject& data, ControllerState& state) {
     QString stick = data["stick"].toString();
     double x = data["x"].toDouble();
     double y = data["y"].toDouble();
     
-    qDebug() << QString("Analog %1: X=%2, Y=%3")
-                .arg(stick, 5)
-                .arg(x, 5, 'f', 2)
-                .arg(y, 5, 'f', 2);
+    VC_LOG_DEBUG(LogCategory::Input, "Analog %5s: X=%5.2f, Y=%5.2f", qUtf8Printable(stick), x, y);
     
     if (stick == "left") {
-        m_currentState.leftStickX = normalizeAnalog(x);
-        m_currentState.leftStickY = normalizeAnalog(y); // in the future, add option for y inversion
+        state.leftStickX = normalizeAnalog(x);
+        state.leftStickY = normalizeAnalog(y); // in the future, add option for y inversion
     } else if (stick == "right") {
-        m_currentState.rightStickX = normalizeAnalog(x);
-        m_currentState.rightStickY = normalizeAnalog(y); // in the future, add option for y inversion
+        state.rightStickX = normalizeAnalog(x);
+        state.rightStickY = normalizeAnalog(y); // in the future, add option for y inversion
     }
 }
 
-void WebSocketInputSource::updateButtonBitmask(const QString& button, bool pressed) {
+void WebSocketInputSource::updateButtonBitmask(const QString& button, bool pressed, ControllerState& state) {
     if (ButtonMap.contains(button)) {
         unsigned short mask = ButtonMap[button];
         
         if (pressed) {
-            m_currentState.buttons |= mask;
+            state.buttons |= mask;
             
             // Mettre à jour les flags D-Pad
-            if (button == "DPAD_UP") m_currentState.dpadUp = true;
-            else if (button == "DPAD_DOWN") m_currentState.dpadDown = true;
-            else if (button == "DPAD_LEFT") m_currentState.dpadLeft = true;
-            else if (button == "DPAD_RIGHT") m_currentState.dpadRight = true;
+            if (button == "DPAD_UP") state.dpadUp = true;
+            else if (button == "DPAD_DOWN") state.dpadDown = true;
+            else if (button == "DPAD_LEFT") state.dpadLeft = true;
+            else if (button == "DPAD_RIGHT") state.dpadRight = true;
         } else {
-            m_currentState.buttons &= ~mask;
+            state.buttons &= ~mask;
             
             // Mettre à jour les flags D-Pad
-            if (button == "DPAD_UP") m_currentState.dpadUp = false;
-            else if (button == "DPAD_DOWN") m_currentState.dpadDown = false;
-            else if (button == "DPAD_LEFT") m_currentState.dpadLeft = false;
-            else if (button == "DPAD_RIGHT") m_currentState.dpadRight = false;
+            if (button == "DPAD_UP") state.dpadUp = false;
+            else if (button == "DPAD_DOWN") state.dpadDown = false;
+            else if (button == "DPAD_LEFT") state.dpadLeft = false;
+            else if (button == "DPAD_RIGHT") state.dpadRight = false;
         }
     }
 }
@@ -6,6 +6,7 @@
 #include <QWebSocket>
 #include <QMap>
 #include <QHostAddress>
+#include <QTimer>
 
 /**
  * @brief Source d'input via WebSocket pour contrôleurs mobiles
@@ -13,11 +14,23 @@
  * Cette classe implémente IInputSource et permet de recevoir des inputs
  * depuis des applications mobiles connectées via WebSocket.
  * Supporte jusqu'à 4 contrôleurs simultanés.
+ * 
+ * Chaque client reçoit un hello annonçant les messages binaires
+ * (ControllerFrame.h) ; les clients qui l'ignorent restent en JSON.
+ * 
+ * stateChanged est limité à setOutputRate() émissions par seconde : le
+ * premier changement après un temps calme part tout de suite, les suivants
+ * sont regroupés jusqu'au prochain tick. Seuls les états différents du
+ * dernier émis sont envoyés, et un bouton ou une gâchette qui change deux
+ * fois dans une même fenêtre force l'émission de l'état intermédiaire
+ * (aucun appui ni relâchement perdu).
  */
 class WebSocketInputSource : public IInputSource {
     Q_OBJECT
     
 public:
+    static constexpr int DEFAULT_OUTPUT_RATE_HZ = 250;
+    
     explicit WebSocketInputSource(int controllerId = 1, QObject* parent = nullptr);
     ~WebSocketInputSource() override;
     
@@ -52,26 +65,50 @@ public:
      */
     int getConnectedClients() const { return m_clients.size(); }
     
+    /**
+     * @brief Fréquence max de stateChanged, en Hz (0 : chaque changement tout de suite)
+     */
+    void setOutputRate(int hz);
+    int getOutputRate() const { return m_outputRateHz; }
+    
 private slots:
     void onNewConnection();
     void onTextMessageReceived(const QString& message);
+    void onBinaryMessageReceived(const QByteArray& message);
     void onClientDisconnected();
+    void onOutputTimer();
     
 private:
-    void processButtonEvent(const QJsonObject& data);
-    void processAnalogEvent(const QJsonObject& data);
-    void updateButtonBitmask(const QString& button, bool pressed);
+    void processButtonEvent(const QJsonObject& data, ControllerState& state);
+    void processAnalogEvent(const QJsonObject& data, ControllerState& state);
+    void updateButtonBitmask(const QString& button, bool pressed, ControllerState& state);
     short normalizeAnalog(double value);
     
+    /**
+     * @brief Adopte next comme état courant et planifie son émission
+     */
+    void applyState(const ControllerState& next);
+    
+    /**
+     * @brief Émet l'état courant s'il diffère du dernier émis
+     */
+    bool flushState();
+    
     QWebSocketServer* m_server;
     QList<QWebSocket*> m_clients;
     ControllerState m_currentState;
     quint16 m_port;
     bool m_isActive;
     
+    // Regroupement de stateChanged
+    QTimer* m_outputTimer;
+    int m_outputRateHz;
+    ControllerState m_lastEmitted;
+    
     // Mapping des boutons vers le bitmask XUSB
     static const QMap<QString, unsigned short> ButtonMap;
 
+    // Niveau debug uniquement (VC_LOG_LEVEL=debug)
     void DebugPrintReceivedMessage(const QString& message);
 };
 
@@ -1,3 +1,5 @@
+import 'dart:typed_data';
+
 /// Model for controller button states
 class ControllerInput {
   final String button;
@@ -73,3 +75,92 @@ class ButtonNames {
   static const String leftStick = 'LEFT_STICK';
   static const String rightStick = 'RIGHT_STICK';
 }
+
+/// Full controller state, sent as one binary WebSocket message once the
+/// desktop app's hello announces support (layout in the launcher's
+/// ControllerFrame.h). Every event updates it, so switching from JSON to
+/// binary frames mid-session keeps the current state.
+class ControllerFrame {
+  static const int version = 1;
+  static const int size = 22;
+
+  /// XUSB button bits
+  static const Map<String, int> buttonBits = {
+    ButtonNames.dpadUp: 0x0001,
+    ButtonNames.dpadDown: 0x0002,
+    ButtonNames.dpadLeft: 0x0004,
+    ButtonNames.dpadRight: 0x0008,
+    ButtonNames.start: 0x0010,
+    ButtonNames.select: 0x0020,
+    ButtonNames.leftStick: 0x0040,
+    ButtonNames.rightStick: 0x0080,
+    ButtonNames.lb: 0x0100,
+    ButtonNames.rb: 0x0200,
+    ButtonNames.a: 0x1000,
+    ButtonNames.b: 0x2000,
+    ButtonNames.x: 0x4000,
+    ButtonNames.y: 0x8000,
+  };
+
+  int buttons = 0;
+  int leftStickX = 0;
+  int leftStickY = 0;
+  int rightStickX = 0;
+  int rightStickY = 0;
+  int leftTrigger = 0; // 0-255; LT/RT are digital buttons on the phone
+  int rightTrigger = 0;
+
+  void reset() {
+    buttons = 0;
+    leftStickX = leftStickY = rightStickX = rightStickY = 0;
+    leftTrigger = rightTrigger = 0;
+  }
+
+  /// Apply a button event; false for a button the frame cannot carry
+  bool setButton(String button, bool isPressed) {
+    if (button == ButtonNames.lt) {
+      leftTrigger = isPressed ? 255 : 0;
+      return true;
+    }
+    if (button == ButtonNames.rt) {
+      rightTrigger = isPressed ? 255 : 0;
+      return true;
+    }
+    final bit = buttonBits[button];
+    if (bit == null) return false;
+    buttons = isPressed ? (buttons | bit) : (buttons & ~bit);
+    return true;
+  }
+
+  /// Apply a stick position (-1.0 to 1.0 per axis)
+  void setStick(String stick, double x, double y) {
+    if (stick == 'left') {
+      leftStickX = _axis(x);
+      leftStickY = _axis(y);
+    } else if (stick == 'right') {
+      rightStickX = _axis(x);
+      rightStickY = _axis(y);
+    }
+  }
+
+  // Same scaling as the desktop app's JSON path
+  static int _axis(double value) => (value.clamp(-1.0, 1.0) * 32767).truncate();
+
+  /// Encode into a new buffer (the socket may still be sending the last one)
+  Uint8List encode(int seq, int timestampMs) {
+    final bytes = Uint8List(size);
+    final data = ByteData.sublistView(bytes);
+    data.setUint8(0, version);
+    data.setUint8(1, 0);
+    data.setUint16(2, buttons, Endian.little);
+    data.setInt16(4, leftStickX, Endian.little);
+    data.setInt16(6, leftStickY, Endian.little);
+    data.setInt16(8, rightStickX, Endian.little);
+    data.setInt16(10, rightStickY, Endian.little);
+    data.setUint8(12, leftTrigger);
+    data.setUint8(13, rightTrigger);
+    data.setUint32(14, seq & 0xFFFFFFFF, Endian.little);
+    data.setUint32(18, timestampMs & 0xFFFFFFFF, Endian.little);
+    return bytes;
+  }
+}
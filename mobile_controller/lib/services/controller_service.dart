@@ -10,6 +10,11 @@ class ControllerService extends ChangeNotifier {
   bool _isConnected = false;
   String _statusMessage = 'Disconnected';
 
+  // Binary frames replace JSON once the desktop app's hello allows them
+  final ControllerFrame _frame = ControllerFrame();
+  bool _binaryFrames = false;
+  int _frameSeq = 0;
+
   bool get isConnected => _isConnected;
   String get statusMessage => _statusMessage;
   String? get serverAddress => _serverAddress;
@@ -31,6 +36,9 @@ class ControllerService extends ChangeNotifier {
 
       _serverAddress = '$host:$port';
       _isConnected = true;
+      _binaryFrames = false;
+      _frame.reset();
+      _frameSeq = 0;
       _statusMessage = 'Connected to $host:$port';
       
       // Listen for messages from server
@@ -64,6 +72,12 @@ class ControllerService extends ChangeNotifier {
   void sendButtonInput(String button, bool isPressed) {
     if (!_isConnected) return;
 
+    final known = _frame.setButton(button, isPressed);
+    if (_binaryFrames) {
+      if (known) _sendFrame();
+      return;
+    }
+
     final input = ControllerInput(
       button: button,
       isPressed: isPressed,
@@ -77,6 +91,12 @@ class ControllerService extends ChangeNotifier {
   void sendAnalogInput(String stick, double x, double y) {
     if (!_isConnected) return;
 
+    _frame.setStick(stick, x, y);
+    if (_binaryFrames) {
+      _sendFrame();
+      return;
+    }
+
     final input = AnalogInput(
       stick: stick,
       x: x,
@@ -98,11 +118,35 @@ class ControllerService extends ChangeNotifier {
     }
   }
 
+  /// Send the whole controller state as one binary frame
+  void _sendFrame() {
+    _frameSeq = (_frameSeq + 1) & 0xFFFFFFFF;
+    try {
+      _channel?.sink.add(_frame.encode(_frameSeq, DateTime.now().millisecondsSinceEpoch));
+    } catch (e) {
+      if (kDebugMode) {
+        print('Error sending frame: $e');
+      }
+    }
+  }
+
   void _handleServerMessage(dynamic message) {
     // Handle any messages from server (e.g., vibration commands)
     if (kDebugMode) {
       print('Received from server: $message');
     }
+    if (message is! String) return;
+
+    try {
+      final data = jsonDecode(message);
+      if (data is Map && data['type'] == 'hello' &&
+          data['binaryVersion'] == ControllerFrame.version) {
+        _binaryFrames = true;
+        _sendFrame(); // state so far, in case events went out as JSON before the hello
+      }
+    } on FormatException {
+      // Not JSON: nothing we understand
+    }
   }
 
   void _handleError(error) {
@@ -0,0 +1,315 @@
+#include "BinarySnapshot.h"
+
+namespace BinarySnapshot {
+
+namespace {
+
+constexpr std::uint8_t PLAYER_HAS_ACK = 0x08;
+
+enum BodyMode : std::uint8_t {
+    BODY_CHAIN = 0,
+    BODY_RAW = 1
+};
+
+// Protocol::Direction codes: Up, Down, Left, Right
+constexpr int STEP_DX[4] = {0, 0, -1, 1};
+constexpr int STEP_DY[4] = {-1, 1, 0, 0};
+
+/// Deltas for the four 2-bit steps packed in each byte (low bits first)
+struct StepTable {
+    std::int8_t dx[256][4];
+    std::int8_t dy[256][4];
+};
+
+constexpr StepTable makeStepTable() {
+    StepTable table{};
+    for (int byte = 0; byte < 256; ++byte) {
+        for (int k = 0; k < 4; ++k) {
+            const int code = (byte >> (2 * k)) & 3;
+            table.dx[byte][k] = static_cast<std::int8_t>(STEP_DX[code]);
+            table.dy[byte][k] = static_cast<std::int8_t>(STEP_DY[code]);
+        }
+    }
+    return table;
+}
+
+constexpr StepTable STEPS = makeStepTable();
+
+// 2-bit code of the step from a to b, or -1 if they are not adjacent
+int stepCode(const Protocol::Vec2& a, const Protocol::Vec2& b) {
+    const int dx = b.x - a.x;
+    const int dy = b.y - a.y;
+    if (dx == 0 && dy == -1) return 0;
+    if (dx == 0 && dy == 1) return 1;
+    if (dx == -1 && dy == 0) return 2;
+    if (dx == 1 && dy == 0) return 3;
+    return -1;
+}
+
+class ByteWriter {
+public:
+    explicit ByteWriter(std::string& out) : m_out(out) {}
+
+    void u8(std::uint8_t v) { m_out.push_back(static_cast<char>(v)); }
+
+    void i16(int v) {
+        const auto u = static_cast<std::uint16_t>(v);
+        u8(static_cast<std::uint8_t>(u));
+        u8(static_cast<std::uint8_t>(u >> 8));
+    }
+
+    void u64(std::uint64_t v) {
+        for (int i = 0; i < 8; ++i) u8(static_cast<std::uint8_t>(v >> (8 * i)));
+    }
+
+    void varint(std::uint64_t v) {
+        while (v >= 0x80) {
+            u8(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        u8(static_cast<std::uint8_t>(v));
+    }
+
+    /// Signed values (scores, ids) zigzag-encoded so small negatives stay short
+    void svarint(std::int64_t v) {
+        varint((static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+    }
+
+private:
+    std::string& m_out;
+};
+
+class ByteReader {
+public:
+    ByteReader(const std::uint8_t* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+    bool ok() const { return m_ok; }
+    size_t remaining() const { return static_cast<size_t>(m_end - m_pos); }
+
+    std::uint8_t u8() {
+        if (m_pos == m_end) return fail();
+        return *m_pos++;
+    }
+
+    int i16() {
+        if (remaining() < 2) return fail();
+        const auto v = static_cast<std::uint16_t>(m_pos[0] | (m_pos[1] << 8));
+        m_pos += 2;
+        return static_cast<std::int16_t>(v);
+    }
+
+    std::uint64_t u64() {
+        if (remaining() < 8) return fail();
+        std::uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<std::uint64_t>(m_pos[i]) << (8 * i);
+        m_pos += 8;
+        return v;
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t b = u8();
+            v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        return fail();
+    }
+
+    std::int64_t svarint() {
+        const std::uint64_t v = varint();
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    /// Counts are bounded by what the remaining bytes could hold
+    size_t count(size_t bytesPerItem) {
+        const std::uint64_t n = varint();
+        if (n > remaining() / bytesPerItem) return fail();
+        return static_cast<size_t>(n);
+    }
+
+    const std::uint8_t* take(size_t n) {
+        if (remaining() < n) {
+            fail();
+            return nullptr;
+        }
+        const std::uint8_t* p = m_pos;
+        m_pos += n;
+        return p;
+    }
+
+private:
+    const std::uint8_t* m_pos;
+    const std::uint8_t* m_end;
+    bool m_ok{true};
+
+    std::uint8_t fail() {
+        m_ok = false;
+        m_pos = m_end;
+        return 0;
+    }
+};
+
+void encodeBody(ByteWriter& out, const std::vector<Protocol::Vec2>& body) {
+    // Repeated tail cells (growth not yet unfolded) are sent as a count
+    size_t pathLength = body.size();
+    while (pathLength > 1 &&
+           body[pathLength - 1].x == body[pathLength - 2].x &&
+           body[pathLength - 1].y == body[pathLength - 2].y) {
+        --pathLength;
+    }
+
+    bool isPath = !body.empty();
+    for (size_t i = 1; i < pathLength && isPath; ++i) {
+        isPath = stepCode(body[i - 1], body[i]) >= 0;
+    }
+
+    if (!isPath) {
+        out.u8(BODY_RAW);
+        out.varint(body.size());
+        for (const auto& c : body) {
+            out.i16(c.x);
+            out.i16(c.y);
+        }
+        return;
+    }
+
+    const size_t steps = pathLength - 1;
+    out.u8(BODY_CHAIN);
+    out.i16(body[0].x);
+    out.i16(body[0].y);
+    out.varint(steps);
+    out.varint(body.size() - pathLength);
+
+    std::uint8_t packed = 0;
+    for (size_t i = 0; i < steps; ++i) {
+        packed |= static_cast<std::uint8_t>(stepCode(body[i], body[i + 1]) << (2 * (i & 3)));
+        if ((i & 3) == 3) {
+            out.u8(packed);
+            packed = 0;
+        }
+    }
+    if (steps & 3) out.u8(packed);
+}
+
+// cellBudget: body cells the rest of the snapshot may still decode
+bool decodeBody(ByteReader& in, std::vector<Protocol::Vec2>& body, size_t& cellBudget) {
+    body.clear();
+
+    const std::uint8_t mode = in.u8();
+    if (mode == BODY_RAW) {
+        const size_t count = in.count(4);
+        if (count > Protocol::MAX_BODY_LENGTH || count > cellBudget) return false;
+        cellBudget -= count;
+        for (size_t i = 0; i < count; ++i) {
+            Protocol::Vec2 c;
+            c.x = in.i16();
+            c.y = in.i16();
+            body.push_back(c);
+        }
+        return in.ok();
+    }
+    if (mode != BODY_CHAIN) return false;
+
+    Protocol::Vec2 cell;
+    cell.x = in.i16();
+    cell.y = in.i16();
+    const std::uint64_t steps = in.varint();
+    const std::uint64_t repeats = in.varint();
+    // Steps are bounded by the payload, but repeats cost no bytes: bound the
+    // length before sizing the body
+    if (!in.ok() || steps > in.remaining() * 4 || repeats > Protocol::MAX_BODY_LENGTH) return false;
+    const std::uint64_t length = 1 + steps + repeats;
+    if (length > Protocol::MAX_BODY_LENGTH || length > cellBudget) return false;
+    cellBudget -= static_cast<size_t>(length);
+
+    const std::uint8_t* packed = in.take(static_cast<size_t>((steps + 3) / 4));
+    if (!packed) return false;
+
+    body.resize(static_cast<size_t>(length));
+    Protocol::Vec2* out = body.data();
+    *out++ = cell;
+
+    // Whole bytes: four table lookups each, no per-step shifting
+    const size_t fullBytes = static_cast<size_t>(steps / 4);
+    for (size_t b = 0; b < fullBytes; ++b) {
+        const std::uint8_t byte = packed[b];
+        for (int k = 0; k < 4; ++k) {
+            cell.x += STEPS.dx[byte][k];
+            cell.y += STEPS.dy[byte][k];
+            *out++ = cell;
+        }
+    }
+    for (int k = 0; k < static_cast<int>(steps & 3); ++k) {
+        const std::uint8_t byte = packed[fullBytes];
+        cell.x += STEPS.dx[byte][k];
+        cell.y += STEPS.dy[byte][k];
+        *out++ = cell;
+    }
+    for (std::uint64_t r = 0; r < repeats; ++r) {
+        *out++ = cell;
+    }
+    return true;
+}
+
+} // namespace
+
+void encode(const Protocol::GameState& state, std::string& out) {
+    out.clear();
+    ByteWriter w(out);
+
+    w.u8(VERSION);
+    w.u8(state.gameActive ? 1 : 0);
+    w.u64(state.hash);
+
+    w.varint(state.players.size());
+    for (const auto& p : state.players) {
+        w.svarint(p.id);
+        w.u8(static_cast<std::uint8_t>((p.alive ? 1 : 0) | (static_cast<int>(p.dir) << 1) |
+                                       (p.ack != 0 ? PLAYER_HAS_ACK : 0)));
+        w.svarint(p.score);
+        if (p.ack != 0) w.varint(p.ack);
+        encodeBody(w, p.body);
+    }
+
+    w.varint(state.food.size());
+    for (const auto& f : state.food) {
+        w.i16(f.x);
+        w.i16(f.y);
+    }
+}
+
+bool decode(const std::uint8_t* data, size_t size, Protocol::GameState& state) {
+    ByteReader in(data, size);
+
+    if (in.u8() != VERSION) return false;
+    const std::uint8_t flags = in.u8();
+    state.gameActive = (flags & 1) != 0;
+    state.hash = in.u64();
+
+    // Smallest player record: id, flags, score, mode, empty raw count
+    const size_t playerCount = in.count(5);
+    if (!in.ok()) return false;
+    state.players.resize(playerCount);
+    size_t cellBudget = Protocol::MAX_SNAPSHOT_CELLS;
+    for (auto& p : state.players) {
+        p.id = static_cast<int>(in.svarint());
+        const std::uint8_t bits = in.u8();
+        p.alive = (bits & 1) != 0;
+        p.dir = static_cast<Protocol::Direction>((bits >> 1) & 3);
+        p.score = static_cast<int>(in.svarint());
+        p.ack = (bits & PLAYER_HAS_ACK) ? static_cast<std::uint32_t>(in.varint()) : 0;
+        if (!decodeBody(in, p.body, cellBudget)) return false;
+    }
+
+    const size_t foodCount = in.count(4);
+    state.food.resize(foodCount);
+    for (auto& f : state.food) {
+        f.x = in.i16();
+        f.y = in.i16();
+    }
+
+    return in.ok() && in.remaining() == 0;
+}
+
+} // namespace BinarySnapshot
@@ -0,0 +1,50 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include "Protocol.h"
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Compact binary encoding of a GameState
+ *
+ * A snake body is a path of adjacent cells, so it is sent as the head
+ * coordinates plus one 2-bit step per further segment (Protocol::Direction
+ * codes, four steps per byte). A grown snake repeats its tail cell until it
+ * moves again; those repeats are sent as a count. A body that is not a
+ * path falls back to raw coordinates.
+ *
+ *   u8 version, u8 flags (bit 0: active), u64 hash
+ *   varint players, per player:
+ *     svarint id, u8 alive | dir << 1 | hasAck << 3, svarint score
+ *     varint ack (only with hasAck)
+ *     u8 body mode
+ *       CHAIN: i16 x, i16 y, varint steps, varint tailRepeats, packed steps
+ *       RAW:   varint count, count * (i16 x, i16 y)
+ *   varint food, food * (i16 x, i16 y)
+ *
+ * Integers are little endian, varints are LEB128 (svarint: zigzag). A
+ * 3-segment body costs 8 bytes instead of about 50 in JSON.
+ */
+namespace BinarySnapshot {
+
+constexpr std::uint8_t VERSION = 2;
+
+/**
+ * @brief Encode state into out (cleared first, storage reused)
+ */
+void encode(const Protocol::GameState& state, std::string& out);
+
+/**
+ * @brief Decode into state, reusing its vectors
+ *
+ * Table-driven: each packed byte expands to four steps through a
+ * precomputed delta table. Returns false on truncated or invalid input,
+ * including bodies longer than Protocol::MAX_BODY_LENGTH or more than
+ * Protocol::MAX_SNAPSHOT_CELLS body cells in total.
+ */
+bool decode(const std::uint8_t* data, size_t size, Protocol::GameState& state);
+
+} // namespace BinarySnapshot
+
+#endif // BINARYSNAPSHOT_H
@@ -0,0 +1,105 @@
+#include "Frame.h"
+#include "BinarySnapshot.h"
+#include "JsonReader.h"
+#include <cstring>
+
+namespace Frame {
+
+namespace {
+
+constexpr std::uint8_t MAGIC_0 = 'V';
+constexpr std::uint8_t MAGIC_1 = 'C';
+
+void writeU32(std::uint8_t* out, std::uint32_t v) {
+    out[0] = static_cast<std::uint8_t>(v);
+    out[1] = static_cast<std::uint8_t>(v >> 8);
+    out[2] = static_cast<std::uint8_t>(v >> 16);
+    out[3] = static_cast<std::uint8_t>(v >> 24);
+}
+
+std::uint32_t readU32(const std::uint8_t* in) {
+    return static_cast<std::uint32_t>(in[0]) |
+           (static_cast<std::uint32_t>(in[1]) << 8) |
+           (static_cast<std::uint32_t>(in[2]) << 16) |
+           (static_cast<std::uint32_t>(in[3]) << 24);
+}
+
+} // namespace
+
+void writeHeader(std::uint8_t* out, const Header& header) {
+    out[0] = MAGIC_0;
+    out[1] = MAGIC_1;
+    out[2] = FRAME_VERSION;
+    out[3] = header.flags;
+    writeU32(out + 4, header.payloadSize);
+    writeU32(out + 8, header.rawSize);
+}
+
+bool readHeader(const std::uint8_t* in, Header& header) {
+    if (in[0] != MAGIC_0 || in[1] != MAGIC_1 || in[2] != FRAME_VERSION) return false;
+
+    header.flags = in[3];
+    header.payloadSize = readU32(in + 4);
+    header.rawSize = readU32(in + 8);
+
+    if (header.rawSize > MAX_RAW_SIZE) return false;
+    if (!(header.flags & FLAG_COMPRESSED) && header.payloadSize != header.rawSize) return false;
+    return header.payloadSize <= Lz::compressBound(header.rawSize);
+}
+
+std::string_view Encoder::encode(std::string_view message, std::uint8_t flags) {
+    const size_t bound = Lz::compressBound(message.size());
+    if (m_buffer.size() < HEADER_SIZE + bound) {
+        m_buffer.resize(HEADER_SIZE + bound);
+    }
+    auto* out = reinterpret_cast<std::uint8_t*>(&m_buffer[0]);
+
+    Header header;
+    header.flags = flags & FLAG_BINARY;
+    header.rawSize = static_cast<std::uint32_t>(message.size());
+    header.payloadSize = header.rawSize;
+
+    size_t compressed = 0;
+    if (message.size() >= m_minCompressSize) {
+        compressed = m_compressor.compress(
+            reinterpret_cast<const std::uint8_t*>(message.data()), message.size(),
+            out + HEADER_SIZE, bound);
+    }
+
+    m_lastCompressed = compressed != 0 && compressed < message.size();
+    if (m_lastCompressed) {
+        header.flags |= FLAG_COMPRESSED;
+        header.payloadSize = static_cast<std::uint32_t>(compressed);
+    } else {
+        std::memcpy(out + HEADER_SIZE, message.data(), message.size());
+    }
+
+    writeHeader(out, header);
+    return std::string_view(m_buffer.data(), HEADER_SIZE + header.payloadSize);
+}
+
+bool decodePayload(const Header& header, const std::uint8_t* payload, std::string& out) {
+    out.resize(header.rawSize);
+    auto* dst = reinterpret_cast<std::uint8_t*>(&out[0]);
+
+    if (header.flags & FLAG_COMPRESSED) {
+        return Lz::decompress(payload, header.payloadSize, dst, header.rawSize);
+    }
+    std::memcpy(dst, payload, header.rawSize);
+    return true;
+}
+
+bool decodeState(const Header& header, const std::uint8_t* payload,
+                 std::string& scratch, Protocol::GameState& state) {
+    if (!decodePayload(header, payload, scratch)) return false;
+
+    if (header.flags & FLAG_BINARY) {
+        return BinarySnapshot::decode(reinterpret_cast<const std::uint8_t*>(scratch.data()),
+                                      scratch.size(), state);
+    }
+    std::string_view text(scratch);
+    if (!text.empty() && text.back() == '\n') text.remove_suffix(1);
+    return readGameState(text, state) == ParseError::None;
+}
+
+} // namespace Frame
@@ -0,0 +1,93 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "Lz.h"
+#include "Protocol.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Length-prefixed binary frames for server-to-client messages
+ *
+ * A connection starts on the newline-delimited JSON protocol. A client that
+ * sends {"type":"hello","compression":true} is switched to frames: each
+ * message is a fixed HEADER_SIZE header followed by the payload, which is
+ * the JSON line itself, LZ-compressed when that makes it smaller. With
+ * "binary":true the payload is a BinarySnapshot instead of JSON.
+ *
+ *   offset 0  'V' 'C'       magic
+ *          2  version       FRAME_VERSION
+ *          3  flags         FLAG_COMPRESSED, FLAG_BINARY
+ *          4  payloadSize   u32 LE, bytes following the header
+ *          8  rawSize       u32 LE, decoded message size
+ */
+namespace Frame {
+
+constexpr size_t HEADER_SIZE = 12;
+constexpr std::uint8_t FRAME_VERSION = 1;
+constexpr std::uint8_t FLAG_COMPRESSED = 0x01;
+constexpr std::uint8_t FLAG_BINARY = 0x02;      // payload is a BinarySnapshot
+
+/// Decoders reject frames claiming more than this (hostile sizes)
+constexpr std::uint32_t MAX_RAW_SIZE = 16u << 20;
+
+/// Messages below this size are sent uncompressed
+constexpr size_t DEFAULT_MIN_COMPRESS_SIZE = 512;
+
+struct Header {
+    std::uint8_t flags{0};
+    std::uint32_t payloadSize{0};
+    std::uint32_t rawSize{0};
+};
+
+void writeHeader(std::uint8_t* out, const Header& header);
+
+/**
+ * @brief Parse a header; false on bad magic, version or sizes
+ */
+bool readHeader(const std::uint8_t* in, Header& header);
+
+/**
+ * @brief Builds frames in a reused buffer
+ */
+class Encoder {
+public:
+    explicit Encoder(size_t minCompressSize = DEFAULT_MIN_COMPRESS_SIZE)
+        : m_minCompressSize(minCompressSize) {}
+
+    /**
+     * @brief Frame a message (view valid until the next call)
+     *
+     * flags may carry FLAG_BINARY; FLAG_COMPRESSED is decided here.
+     */
+    std::string_view encode(std::string_view message, std::uint8_t flags = 0);
+
+    /// True if the last encode() compressed its message
+    bool lastCompressed() const { return m_lastCompressed; }
+
+private:
+    size_t m_minCompressSize;
+    std::string m_buffer;
+    Lz::Compressor m_compressor;
+    bool m_lastCompressed{false};
+};
+
+/**
+ * @brief Decode the payload of a frame whose header was read into header
+ *
+ * out is resized to header.rawSize and reused between calls.
+ */
+bool decodePayload(const Header& header, const std::uint8_t* payload, std::string& out);
+
+/**
+ * @brief Decode a state snapshot frame, JSON or binary
+ *
+ * scratch holds the decompressed payload and is reused between calls.
+ */
+bool decodeState(const Header& header, const std::uint8_t* payload,
+                 std::string& scratch, Protocol::GameState& state);
+
+} // namespace Frame
+
+#endif // FRAME_H
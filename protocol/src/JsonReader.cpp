@@ -0,0 +1,412 @@
+#include "JsonReader.h"
+#include <vector>
+
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+JsonTokenizer::Token JsonTokenizer::fail() {
+    m_failed = true;
+    return Token::Error;
+}
+
+JsonTokenizer::Token JsonTokenizer::next() {
+    if (m_failed) return Token::Error;
+
+    while (m_pos < m_text.size() && isSpace(m_text[m_pos])) ++m_pos;
+    if (m_pos == m_text.size()) return Token::End;
+
+    switch (m_text[m_pos]) {
+        case '{': ++m_pos; return Token::ObjectBegin;
+        case '}': ++m_pos; return Token::ObjectEnd;
+        case '[': ++m_pos; return Token::ArrayBegin;
+        case ']': ++m_pos; return Token::ArrayEnd;
+        case ':': ++m_pos; return Token::Colon;
+        case ',': ++m_pos; return Token::Comma;
+        case '"': return lexString();
+        case 't': return lexLiteral("true", Token::True);
+        case 'f': return lexLiteral("false", Token::False);
+        case 'n': return lexLiteral("null", Token::Null);
+        default:  return lexNumber();
+    }
+}
+
+JsonTokenizer::Token JsonTokenizer::lexString() {
+    const size_t start = ++m_pos;
+    while (m_pos < m_text.size()) {
+        const char c = m_text[m_pos];
+        if (c == '"') {
+            m_string = m_text.substr(start, m_pos - start);
+            ++m_pos;
+            return Token::String;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) return fail();
+        // Escapes stay encoded; only make sure one does not eat the quote
+        m_pos += (c == '\\') ? 2 : 1;
+    }
+    return fail();
+}
+
+JsonTokenizer::Token JsonTokenizer::lexNumber() {
+    bool negative = false;
+    if (m_text[m_pos] == '-') {
+        negative = true;
+        ++m_pos;
+    }
+
+    // Accumulate in 64 bits and stop counting once past the uint32 range
+    constexpr long long LIMIT = 1ll << 32;
+    long long value = 0;
+    const size_t digitsStart = m_pos;
+    while (m_pos < m_text.size() && isDigit(m_text[m_pos])) {
+        if (value < LIMIT) value = value * 10 + (m_text[m_pos] - '0');
+        ++m_pos;
+    }
+    if (m_pos == digitsStart) return fail();
+    // JSON forbids leading zeros
+    if (m_text[digitsStart] == '0' && m_pos - digitsStart > 1) return fail();
+
+    bool integral = true;
+    if (m_pos < m_text.size() && m_text[m_pos] == '.') {
+        integral = false;
+        const size_t fracStart = ++m_pos;
+        while (m_pos < m_text.size() && isDigit(m_text[m_pos])) ++m_pos;
+        if (m_pos == fracStart) return fail();
+    }
+    if (m_pos < m_text.size() && (m_text[m_pos] == 'e' || m_text[m_pos] == 'E')) {
+        integral = false;
+        ++m_pos;
+        if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-')) ++m_pos;
+        const size_t expStart = m_pos;
+        while (m_pos < m_text.size() && isDigit(m_text[m_pos])) ++m_pos;
+        if (m_pos == expStart) return fail();
+    }
+
+    if (negative) value = -value;
+    m_isInt = integral && value >= INT32_MIN && value <= INT32_MAX;
+    m_int = m_isInt ? static_cast<int>(value) : 0;
+    m_isUint32 = integral && value >= 0 && value <= UINT32_MAX;
+    m_uint32 = m_isUint32 ? static_cast<std::uint32_t>(value) : 0;
+    return Token::Number;
+}
+
+JsonTokenizer::Token JsonTokenizer::lexLiteral(std::string_view literal, Token token) {
+    if (m_text.substr(m_pos, literal.size()) != literal) return fail();
+    m_pos += literal.size();
+    return token;
+}
+
+bool JsonTokenizer::skipValue(Token first) {
+    if (first == Token::Colon || first == Token::Comma) return false;
+
+    int depth = 0;
+    Token token = first;
+    while (true) {
+        switch (token) {
+            case Token::ObjectBegin:
+            case Token::ArrayBegin:
+                if (++depth > MAX_DEPTH) return false;
+                break;
+            case Token::ObjectEnd:
+            case Token::ArrayEnd:
+                if (--depth < 0) return false;
+                break;
+            case Token::End:
+            case Token::Error:
+                return false;
+            default:
+                // Structure inside containers is not checked, only balanced
+                break;
+        }
+        if (depth == 0) return true;
+        token = next();
+    }
+}
+
+namespace {
+
+using Token = JsonTokenizer::Token;
+
+/**
+ * Walk the members of an object whose first token was just read.
+ * onField(key, valueToken) must consume the whole value.
+ */
+template <typename OnField>
+ParseError readObject(JsonTokenizer& tokens, Token first, OnField&& onField) {
+    if (first != Token::ObjectBegin) return ParseError::Malformed;
+
+    Token token = tokens.next();
+    if (token == Token::ObjectEnd) return ParseError::None;
+    while (true) {
+        if (token != Token::String) return ParseError::Malformed;
+        const std::string_view key = tokens.string();
+        if (tokens.next() != Token::Colon) return ParseError::Malformed;
+
+        ParseError error = onField(key, tokens.next());
+        if (error != ParseError::None) return error;
+
+        token = tokens.next();
+        if (token == Token::ObjectEnd) return ParseError::None;
+        if (token != Token::Comma) return ParseError::Malformed;
+        token = tokens.next();
+    }
+}
+
+/// Same for array elements: onItem(firstToken) consumes one element
+template <typename OnItem>
+ParseError readArray(JsonTokenizer& tokens, Token first, OnItem&& onItem) {
+    if (first != Token::ArrayBegin) return ParseError::Malformed;
+
+    Token token = tokens.next();
+    if (token == Token::ArrayEnd) return ParseError::None;
+    while (true) {
+        ParseError error = onItem(token);
+        if (error != ParseError::None) return error;
+
+        token = tokens.next();
+        if (token == Token::ArrayEnd) return ParseError::None;
+        if (token != Token::Comma) return ParseError::Malformed;
+        token = tokens.next();
+    }
+}
+
+ParseError skipField(JsonTokenizer& tokens, Token value) {
+    return tokens.skipValue(value) ? ParseError::None : ParseError::Malformed;
+}
+
+ParseError readInt(const JsonTokenizer& tokens, Token value, int& out) {
+    if (value != Token::Number || !tokens.isInt()) return ParseError::BadField;
+    out = tokens.intValue();
+    return ParseError::None;
+}
+
+ParseError readUint(const JsonTokenizer& tokens, Token value, std::uint32_t& out) {
+    if (value != Token::Number || !tokens.isUint32()) return ParseError::BadField;
+    out = tokens.uint32Value();
+    return ParseError::None;
+}
+
+ParseError readBool(Token value, bool& out) {
+    if (value != Token::True && value != Token::False) return ParseError::BadField;
+    out = value == Token::True;
+    return ParseError::None;
+}
+
+ParseError readDirection(const JsonTokenizer& tokens, Token value, Protocol::Direction& out) {
+    int dir = 0;
+    if (readInt(tokens, value, dir) != ParseError::None || dir < 0 || dir > 3) {
+        return ParseError::BadField;
+    }
+    out = static_cast<Protocol::Direction>(dir);
+    return ParseError::None;
+}
+
+ParseError readHex64(const JsonTokenizer& tokens, Token value, std::uint64_t& out) {
+    if (value != Token::String) return ParseError::BadField;
+    const std::string_view text = tokens.string();
+    if (text.empty() || text.size() > 16) return ParseError::BadField;
+
+    std::uint64_t result = 0;
+    for (char c : text) {
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return ParseError::BadField;
+        result = (result << 4) | static_cast<std::uint64_t>(digit);
+    }
+    out = result;
+    return ParseError::None;
+}
+
+ParseError readCells(JsonTokenizer& tokens, Token first, std::vector<Protocol::Vec2>& cells) {
+    cells.clear();
+    return readArray(tokens, first, [&](Token item) {
+        Protocol::Vec2 cell;
+        bool hasX = false;
+        bool hasY = false;
+        ParseError error = readObject(tokens, item, [&](std::string_view key, Token value) {
+            if (key == "x") { hasX = true; return readInt(tokens, value, cell.x); }
+            if (key == "y") { hasY = true; return readInt(tokens, value, cell.y); }
+            return skipField(tokens, value);
+        });
+        if (error != ParseError::None) return error;
+        if (!hasX || !hasY) return ParseError::MissingField;
+        cells.push_back(cell);
+        return ParseError::None;
+    });
+}
+
+ParseError readPlayer(JsonTokenizer& tokens, Token first, Protocol::PlayerState& p) {
+    // Reset to defaults but keep the body's storage
+    p.id = 0;
+    p.alive = true;
+    p.dir = Protocol::Direction::Right;
+    p.score = 0;
+    p.ack = 0;
+    p.body.clear();
+
+    bool hasId = false;
+    ParseError error = readObject(tokens, first, [&](std::string_view key, Token value) {
+        if (key == "id")    { hasId = true; return readInt(tokens, value, p.id); }
+        if (key == "alive") return readBool(value, p.alive);
+        if (key == "dir")   return readDirection(tokens, value, p.dir);
+        if (key == "score") return readInt(tokens, value, p.score);
+        if (key == "ack")   return readUint(tokens, value, p.ack);
+        if (key == "body")  return readCells(tokens, value, p.body);
+        return skipField(tokens, value);
+    });
+    if (error != ParseError::None) return error;
+    return hasId ? ParseError::None : ParseError::MissingField;
+}
+
+} // namespace
+
+ParseError parseClientMessage(std::string_view data, Protocol::Message& msg) {
+    msg.type = Protocol::MessageType::MSG_ERROR;
+    msg.playerId = -1;
+    msg.seq = 0;
+    msg.compression = false;
+    msg.binary = false;
+    if (data.size() > MAX_MESSAGE_SIZE) return ParseError::Oversized;
+
+    std::string_view type;
+    bool hasDirection = false;
+    bool badField = false;
+    Protocol::Direction direction = Protocol::Direction::Right;
+    int playerId = -1;
+    std::uint32_t seq = 0;
+    bool compression = false;
+    bool binary = false;
+
+    JsonTokenizer tokens(data);
+    ParseError error = readObject(tokens, tokens.next(), [&](std::string_view key, Token value) {
+        if (key == "type") {
+            type = value == Token::String ? tokens.string() : std::string_view();
+        } else if (key == "direction") {
+            hasDirection = true;
+            badField |= readDirection(tokens, value, direction) != ParseError::None;
+        } else if (key == "playerId") {
+            badField |= readInt(tokens, value, playerId) != ParseError::None || playerId < 0;
+        } else if (key == "seq") {
+            badField |= readUint(tokens, value, seq) != ParseError::None;
+        } else if (key == "compression") {
+            badField |= readBool(value, compression) != ParseError::None;
+        } else if (key == "binary") {
+            badField |= readBool(value, binary) != ParseError::None;
+        }
+        // Known fields were scalars; this also steps over unknown ones
+        return skipField(tokens, value);
+    });
+    if (error != ParseError::None) return error;
+    if (tokens.next() != Token::End) return ParseError::Malformed;
+
+    if (type == "input") {
+        if (badField) return ParseError::BadField;
+        if (!hasDirection) return ParseError::MissingField;
+        msg.type = Protocol::MessageType::INPUT;
+        msg.direction = direction;
+        msg.playerId = playerId;
+        msg.seq = seq;
+        return ParseError::None;
+    }
+    if (type == "ping") {
+        if (badField) return ParseError::BadField;
+        msg.type = Protocol::MessageType::PING;
+        msg.seq = seq;
+        return ParseError::None;
+    }
+    if (type == "hello") {
+        if (badField) return ParseError::BadField;
+        msg.type = Protocol::MessageType::HELLO;
+        msg.compression = compression;
+        msg.binary = binary;
+        return ParseError::None;
+    }
+    return ParseError::UnknownType;
+}
+
+ParseError readGameState(std::string_view data, Protocol::GameState& state) {
+    bool isState = false;
+    bool hasActive = false;
+    bool hasPlayers = false;
+    bool hasFood = false;
+    size_t playerCount = 0;
+    state.hash = 0;
+
+    JsonTokenizer tokens(data);
+    ParseError error = readObject(tokens, tokens.next(), [&](std::string_view key, Token value) {
+        if (key == "type") {
+            isState = value == Token::String && tokens.string() == "state";
+            return skipField(tokens, value);
+        }
+        if (key == "active") {
+            hasActive = true;
+            return readBool(value, state.gameActive);
+        }
+        if (key == "players") {
+            hasPlayers = true;
+            playerCount = 0;
+            return readArray(tokens, value, [&](Token item) {
+                if (playerCount == state.players.size()) state.players.emplace_back();
+                return readPlayer(tokens, item, state.players[playerCount++]);
+            });
+        }
+        if (key == "food") {
+            hasFood = true;
+            return readCells(tokens, value, state.food);
+        }
+        if (key == "hash") return readHex64(tokens, value, state.hash);
+        return skipField(tokens, value);
+    });
+    state.players.resize(playerCount);
+    if (error != ParseError::None) return error;
+    if (tokens.next() != Token::End) return ParseError::Malformed;
+
+    if (!isState) return ParseError::UnknownType;
+    if (!hasActive || !hasPlayers || !hasFood) return ParseError::MissingField;
+    return ParseError::None;
+}
+
+ParseError readPong(std::string_view data, std::uint32_t& seq) {
+    if (!data.empty() && data.back() == '\n') data.remove_suffix(1);
+
+    bool isPong = false;
+    bool hasSeq = false;
+    JsonTokenizer tokens(data);
+    ParseError error = readObject(tokens, tokens.next(), [&](std::string_view key, Token value) {
+        if (key == "type") {
+            isPong = value == Token::String && tokens.string() == "pong";
+            return skipField(tokens, value);
+        }
+        if (key == "seq") {
+            hasSeq = true;
+            return readUint(tokens, value, seq);
+        }
+        return skipField(tokens, value);
+    });
+    if (error != ParseError::None) return error;
+    if (tokens.next() != Token::End) return ParseError::Malformed;
+    if (!isPong) return ParseError::UnknownType;
+    return hasSeq ? ParseError::None : ParseError::MissingField;
+}
+
+const char* parseErrorName(ParseError error) {
+    switch (error) {
+        case ParseError::None:         return "none";
+        case ParseError::Oversized:    return "oversized";
+        case ParseError::Malformed:    return "malformed";
+        case ParseError::UnknownType:  return "unknownType";
+        case ParseError::MissingField: return "missingField";
+        case ParseError::BadField:     return "badField";
+        default:                       return "?";
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef JSONREADER_H
+#define JSONREADER_H
+
+#include "Protocol.h"
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Single-pass JSON tokenizer over a string_view
+ *
+ * Never allocates and never throws: malformed input yields Token::Error,
+ * after which every call returns Error again. String tokens are views into
+ * the input with escapes left encoded, which is all the protocol's ASCII
+ * keys and values need.
+ */
+class JsonTokenizer {
+public:
+    enum class Token {
+        ObjectBegin,
+        ObjectEnd,
+        ArrayBegin,
+        ArrayEnd,
+        Colon,
+        Comma,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        End,
+        Error
+    };
+
+    explicit JsonTokenizer(std::string_view text) : m_text(text) {}
+
+    Token next();
+
+    /// Contents of the last String token, without the quotes
+    std::string_view string() const { return m_string; }
+
+    /// True when the last Number token was an integer that fits in 32 bits
+    bool isInt() const { return m_isInt; }
+
+    /// Value of the last Number token (valid when isInt())
+    int intValue() const { return m_int; }
+
+    /// True when the last Number token was an integer in [0, UINT32_MAX]
+    bool isUint32() const { return m_isUint32; }
+
+    /// Value of the last Number token (valid when isUint32())
+    std::uint32_t uint32Value() const { return m_uint32; }
+
+    /**
+     * @brief Skip the value whose first token was just returned
+     *
+     * Nested containers are skipped up to MAX_DEPTH levels.
+     */
+    bool skipValue(Token first);
+
+    static constexpr int MAX_DEPTH = 16;
+
+private:
+    std::string_view m_text;
+    size_t m_pos{0};
+    bool m_failed{false};
+
+    std::string_view m_string;
+    int m_int{0};
+    bool m_isInt{false};
+    std::uint32_t m_uint32{0};
+    bool m_isUint32{false};
+
+    Token fail();
+    Token lexString();
+    Token lexNumber();
+    Token lexLiteral(std::string_view literal, Token token);
+};
+
+/**
+ * @brief Why a client message was rejected
+ */
+enum class ParseError {
+    None,
+    Oversized,      // longer than MAX_MESSAGE_SIZE
+    Malformed,      // not a single well-formed JSON object
+    UnknownType,    // "type" missing or not a message the server accepts
+    MissingField,   // a required field is absent
+    BadField,       // a field has the wrong type or is out of range
+    Count
+};
+
+constexpr size_t MAX_MESSAGE_SIZE = 1024;
+
+/**
+ * @brief Parse one client message: input, hello or ping (one line, without the newline)
+ *
+ * On success fills msg and returns ParseError::None. On failure msg.type
+ * is MSG_ERROR. Cost is linear in the message length.
+ */
+ParseError parseClientMessage(std::string_view data, Protocol::Message& msg);
+
+/**
+ * @brief Decode a state snapshot (one line, newline optional)
+ *
+ * The inverse of writeGameState(). Vectors in state are reused, so a
+ * client decoding every tick into the same GameState stops allocating once
+ * they have grown to the arena size. Unknown fields are skipped. On error
+ * state holds a partially decoded snapshot and must not be used.
+ */
+ParseError readGameState(std::string_view data, Protocol::GameState& state);
+
+/// Every pong line starts with this (see writePong())
+constexpr std::string_view PONG_PREFIX = "{\"type\":\"pong\"";
+
+/**
+ * @brief Decode a pong (one line, newline optional) into its seq
+ */
+ParseError readPong(std::string_view data, std::uint32_t& seq);
+
+const char* parseErrorName(ParseError error);
+
+#endif // JSONREADER_H
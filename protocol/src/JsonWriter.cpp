@@ -0,0 +1,63 @@
+#include "JsonWriter.h"
+
+namespace {
+
+void writeCell(JsonWriter& out, const Protocol::Vec2& cell) {
+    out.raw("{\"x\":").integer(cell.x).raw(",\"y\":").integer(cell.y).raw('}');
+}
+
+} // namespace
+
+void writeGameState(JsonWriter& out, const Protocol::GameState& state) {
+    out.raw("{\"type\":\"state\",\"active\":").boolean(state.gameActive);
+
+    // Serialize players
+    out.raw(",\"players\":[");
+    for (size_t i = 0; i < state.players.size(); ++i) {
+        const auto& p = state.players[i];
+        if (i > 0) out.raw(',');
+        out.raw("{\"id\":").integer(p.id)
+           .raw(",\"alive\":").boolean(p.alive)
+           .raw(",\"dir\":").integer(static_cast<int>(p.dir))
+           .raw(",\"score\":").integer(p.score);
+        if (p.ack != 0) out.raw(",\"ack\":").integer(p.ack);
+        out.raw(",\"body\":[");
+        for (size_t j = 0; j < p.body.size(); ++j) {
+            if (j > 0) out.raw(',');
+            writeCell(out, p.body[j]);
+        }
+        out.raw("]}");
+    }
+    out.raw(']');
+
+    // Serialize food
+    out.raw(",\"food\":[");
+    for (size_t i = 0; i < state.food.size(); ++i) {
+        if (i > 0) out.raw(',');
+        writeCell(out, state.food[i]);
+    }
+    out.raw(']');
+
+    // State hash as 16 hex digits (JSON numbers cannot carry 64 bits)
+    out.raw(",\"hash\":\"").hex64(state.hash).raw("\"}\n");
+}
+
+void writeInput(JsonWriter& out, int playerId, Protocol::Direction direction, std::uint32_t seq) {
+    out.raw("{\"type\":\"input\",\"playerId\":").integer(playerId)
+       .raw(",\"direction\":").integer(static_cast<int>(direction));
+    if (seq != 0) out.raw(",\"seq\":").integer(seq);
+    out.raw("}\n");
+}
+
+void writePing(JsonWriter& out, std::uint32_t seq) {
+    out.raw("{\"type\":\"ping\",\"seq\":").integer(seq).raw("}\n");
+}
+
+void writePong(JsonWriter& out, std::uint32_t seq) {
+    out.raw("{\"type\":\"pong\",\"seq\":").integer(seq).raw("}\n");
+}
+
+void writeHello(JsonWriter& out, bool compression, bool binary) {
+    out.raw("{\"type\":\"hello\",\"compression\":").boolean(compression)
+       .raw(",\"binary\":").boolean(binary).raw("}\n");
+}
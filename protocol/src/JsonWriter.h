@@ -0,0 +1,127 @@
+#ifndef JSONWRITER_H
+#define JSONWRITER_H
+
+#include "Protocol.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Append-only JSON text builder over a reusable buffer
+ *
+ * Replaces std::ostringstream on the snapshot path: integers go through
+ * std::to_chars (no locale, no virtual calls) and the buffer is kept
+ * between messages, so once it has grown to the snapshot size a steady
+ * game allocates nothing. begin() reserves the previous message length
+ * up front, so a growing state costs at most one reallocation per message.
+ */
+class JsonWriter {
+public:
+    /**
+     * @brief Start a new message, keeping the buffer's storage
+     */
+    void begin() {
+        m_size = 0;
+        // Room for the previous message plus some slack for growth
+        ensure(m_lastSize + m_lastSize / 8);
+    }
+
+    /**
+     * @brief Finish the message and return its text (valid until begin())
+     */
+    std::string_view finish() {
+        m_lastSize = m_size;
+        return view();
+    }
+
+    std::string_view view() const { return std::string_view(m_buffer.data(), m_size); }
+
+    JsonWriter& raw(std::string_view text) {
+        char* out = ensure(text.size());
+        std::memcpy(out, text.data(), text.size());
+        m_size += text.size();
+        return *this;
+    }
+
+    JsonWriter& raw(char c) {
+        *ensure(1) = c;
+        ++m_size;
+        return *this;
+    }
+
+    JsonWriter& integer(long long value) {
+        constexpr size_t MAX_DIGITS = 20; // sign + 19 digits
+        char* out = ensure(MAX_DIGITS);
+        auto result = std::to_chars(out, out + MAX_DIGITS, value);
+        m_size += static_cast<size_t>(result.ptr - out);
+        return *this;
+    }
+
+    JsonWriter& boolean(bool value) {
+        return raw(value ? std::string_view("true") : std::string_view("false"));
+    }
+
+    /// 16 lowercase hex digits, zero padded (64-bit values as JSON strings)
+    JsonWriter& hex64(std::uint64_t value) {
+        static constexpr char DIGITS[] = "0123456789abcdef";
+        char* out = ensure(16);
+        for (int i = 15; i >= 0; --i) {
+            out[i] = DIGITS[value & 0xF];
+            value >>= 4;
+        }
+        m_size += 16;
+        return *this;
+    }
+
+private:
+    std::string m_buffer;
+    size_t m_size{0};
+    size_t m_lastSize{0};
+
+    // Pointer to at least n writable bytes past the current end
+    char* ensure(size_t n) {
+        if (m_size + n > m_buffer.size()) {
+            m_buffer.resize(std::max(m_buffer.size() * 2, m_size + n));
+        }
+        return m_buffer.data() + m_size;
+    }
+};
+
+/**
+ * @brief Write a state snapshot message, newline terminated
+ *
+ * Produces the same bytes as the former ostringstream serializer; a
+ * player's "ack" is only written when set.
+ */
+void writeGameState(JsonWriter& out, const Protocol::GameState& state);
+
+/**
+ * @brief Write a client input message, newline terminated
+ *
+ * A non-zero seq is sent along and comes back as the player's ack.
+ */
+void writeInput(JsonWriter& out, int playerId, Protocol::Direction direction,
+                std::uint32_t seq = 0);
+
+/**
+ * @brief Write a round-trip probe, newline terminated
+ */
+void writePing(JsonWriter& out, std::uint32_t seq);
+
+/**
+ * @brief Write the answer to a ping, newline terminated
+ *
+ * "type" comes first, so a client can tell a pong from a snapshot by the
+ * line's prefix (PONG_PREFIX in JsonReader.h) before parsing it.
+ */
+void writePong(JsonWriter& out, std::uint32_t seq);
+
+/**
+ * @brief Write the client hello message, newline terminated
+ */
+void writeHello(JsonWriter& out, bool compression, bool binary = false);
+
+#endif // JSONWRITER_H
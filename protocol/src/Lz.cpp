@@ -0,0 +1,153 @@
+#include "Lz.h"
+#include <cstring>
+
+namespace Lz {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+// Matches stop short of the end so the block always finishes on literals
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MIN_INPUT = 13;
+
+std::uint32_t read32(const std::uint8_t* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Write a length continuation (after a nibble of 15)
+std::uint8_t* writeLength(std::uint8_t* op, size_t length) {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<std::uint8_t>(length);
+    return op;
+}
+
+bool readLength(const std::uint8_t*& ip, const std::uint8_t* end, size_t& length) {
+    std::uint8_t b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace
+
+size_t Compressor::compress(const std::uint8_t* src, size_t srcSize,
+                            std::uint8_t* dst, size_t dstCapacity) {
+    const std::uint8_t* ip = src;
+    const std::uint8_t* anchor = src;
+    const std::uint8_t* const end = src + srcSize;
+    std::uint8_t* op = dst;
+    std::uint8_t* const opEnd = dst + dstCapacity;
+
+    // Emit literals [anchor, literalEnd) and, when matchLength > 0, a match
+    auto emit = [&](const std::uint8_t* literalEnd, size_t offset, size_t matchLength) {
+        const size_t literals = static_cast<size_t>(literalEnd - anchor);
+        if (static_cast<size_t>(opEnd - op) < literals + literals / 255 + 3 + matchLength / 255 + 2) {
+            return false;
+        }
+
+        std::uint8_t* token = op++;
+        *token = static_cast<std::uint8_t>((literals < 15 ? literals : 15) << 4);
+        if (literals >= 15) op = writeLength(op, literals - 15);
+        if (literals > 0) std::memcpy(op, anchor, literals);
+        op += literals;
+
+        if (matchLength > 0) {
+            *op++ = static_cast<std::uint8_t>(offset);
+            *op++ = static_cast<std::uint8_t>(offset >> 8);
+            const size_t code = matchLength - MIN_MATCH;
+            *token |= static_cast<std::uint8_t>(code < 15 ? code : 15);
+            if (code >= 15) op = writeLength(op, code - 15);
+        }
+        return true;
+    };
+
+    if (srcSize >= MIN_INPUT) {
+        m_table.fill(0);
+        const std::uint8_t* const matchLimit = end - LAST_LITERALS;
+        const std::uint8_t* const searchLimit = end - MIN_INPUT + 1;
+
+        auto hash = [](std::uint32_t seq) {
+            return (seq * 2654435761u) >> (32 - HASH_BITS);
+        };
+
+        while (ip < searchLimit) {
+            const std::uint32_t seq = read32(ip);
+            const std::uint32_t h = hash(seq);
+            const std::uint32_t candidate = m_table[h];
+            m_table[h] = static_cast<std::uint32_t>(ip - src) + 1;
+
+            const std::uint8_t* ref = candidate != 0 ? src + candidate - 1 : nullptr;
+            if (!ref || static_cast<size_t>(ip - ref) > MAX_OFFSET || read32(ref) != seq) {
+                // Skip faster through data that is not matching
+                ip += 1 + (static_cast<size_t>(ip - anchor) >> 6);
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (ip + length < matchLimit && ref[length] == ip[length]) ++length;
+
+            if (!emit(ip, static_cast<size_t>(ip - ref), length)) return 0;
+            ip += length;
+            anchor = ip;
+        }
+    }
+
+    if (!emit(end, 0, 0)) return 0;
+    return static_cast<size_t>(op - dst);
+}
+
+bool decompress(const std::uint8_t* src, size_t srcSize,
+                std::uint8_t* dst, size_t dstSize) {
+    const std::uint8_t* ip = src;
+    const std::uint8_t* const end = src + srcSize;
+    std::uint8_t* op = dst;
+    std::uint8_t* const opEnd = dst + dstSize;
+
+    while (ip < end) {
+        const std::uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(ip, end, literals)) return false;
+        if (literals > static_cast<size_t>(end - ip) || literals > static_cast<size_t>(opEnd - op)) {
+            return false;
+        }
+        if (literals > 0) std::memcpy(op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        // The last sequence has no match part
+        if (ip == end) break;
+
+        if (end - ip < 2) return false;
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+
+        size_t length = token & 15;
+        if (length == 15 && !readLength(ip, end, length)) return false;
+        length += MIN_MATCH;
+        if (length > static_cast<size_t>(opEnd - op)) return false;
+
+        // Byte copy when the match overlaps the bytes it produces
+        const std::uint8_t* match = op - offset;
+        if (offset >= length) {
+            std::memcpy(op, match, length);
+        } else {
+            for (size_t i = 0; i < length; ++i) op[i] = match[i];
+        }
+        op += length;
+    }
+
+    return op == opEnd;
+}
+
+} // namespace Lz
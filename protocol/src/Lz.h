@@ -0,0 +1,56 @@
+#ifndef LZ_H
+#define LZ_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Small LZ77 byte codec in the LZ4 block style
+ *
+ * A compressed block is a run of sequences: a token byte (literal count in
+ * the high nibble, match length - 4 in the low one, 15 meaning "more bytes
+ * follow, 255 at a time"), the literals, then a 16-bit little-endian match
+ * offset. The last sequence carries literals only. Greedy matching over a
+ * single-probe hash table keeps compression in the hundreds of MB/s, which
+ * suits per-tick snapshots whose JSON keys repeat heavily.
+ *
+ * decompress() bounds-checks every read and write, so it is safe on data
+ * received from the network.
+ */
+namespace Lz {
+
+/// Largest output compress() can produce for n input bytes
+constexpr size_t compressBound(size_t n) {
+    return n + n / 255 + 16;
+}
+
+class Compressor {
+public:
+    /**
+     * @brief Compress src into dst
+     *
+     * @return Compressed size, or 0 if dst is too small
+     */
+    size_t compress(const std::uint8_t* src, size_t srcSize,
+                    std::uint8_t* dst, size_t dstCapacity);
+
+private:
+    static constexpr int HASH_BITS = 12;
+
+    // Position + 1 of the last 4-byte sequence with each hash (0 = none);
+    // kept as a member so compressing allocates nothing
+    std::array<std::uint32_t, 1 << HASH_BITS> m_table{};
+};
+
+/**
+ * @brief Decompress exactly dstSize bytes
+ *
+ * @return False if the block is corrupt or does not decode to dstSize bytes
+ */
+bool decompress(const std::uint8_t* src, size_t srcSize,
+                std::uint8_t* dst, size_t dstSize);
+
+} // namespace Lz
+
+#endif // LZ_H
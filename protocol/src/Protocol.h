@@ -1,6 +1,8 @@
 #ifndef PROTOCOL_H
 #define PROTOCOL_H
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -17,9 +19,17 @@ enum class MessageType {
     INPUT,          // Client sends input command
     STATE_UPDATE,   // Server broadcasts game state
     START_GAME,     // Start a new game
+    HELLO,          // Client announces capabilities (frames, compression)
+    PING,           // Client round-trip probe, answered with a pong
+    PONG,           // Server echo of a ping's seq
     MSG_ERROR       // Error message (renamed to avoid Windows ERROR macro)
 };
 
+// Decoder limits: a body never covers more cells than the arena holds, and
+// the largest preset arena is 320x320 (GameLogic.h checks its presets)
+constexpr size_t MAX_BODY_LENGTH = 1 << 17;     // cells in one snake
+constexpr size_t MAX_SNAPSHOT_CELLS = 1 << 18;  // body cells of all snakes in a snapshot
+
 // Direction enumeration (matches game logic)
 enum class Direction {
     Up = 0,
@@ -41,6 +51,7 @@ struct PlayerState {
     Direction dir{Direction::Right};
     std::vector<Vec2> body;
     int score{0};
+    std::uint32_t ack{0};   // seq of the newest input applied for this player (0: none)
 };
 
 // Game state structure
@@ -48,6 +59,7 @@ struct GameState {
     std::vector<PlayerState> players;
     std::vector<Vec2> food;
     bool gameActive{false};
+    std::uint64_t hash{0};  // StateHash of this state, for desync checks
 };
 
 // Input command structure
@@ -61,6 +73,10 @@ struct Message {
     MessageType type;
     int playerId{-1};
     Direction direction{Direction::Right};
+    std::uint32_t seq{0};     // INPUT: client sequence number (0: none), echoed as ack
+                              // PING/PONG: probe id, echoed unchanged
+    bool compression{false};  // HELLO: client accepts compressed frames
+    bool binary{false};       // HELLO: client wants BinarySnapshot frames
     GameState state;
     std::string error;
 };
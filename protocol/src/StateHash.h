@@ -0,0 +1,94 @@
+#ifndef STATEHASH_H
+#define STATEHASH_H
+
+#include "Protocol.h"
+#include <cstdint>
+
+/**
+ * @brief 64-bit state hash for cheap desync detection
+ *
+ * Zobrist-style: every piece of state (a body segment, a food item, a
+ * direction, a death, a score point) owns a pseudo-random key, and the hash
+ * is the sum of the keys present. GameLogic updates it incrementally as
+ * heads are pushed, tails popped and food moved; compute() rebuilds it from
+ * a decoded snapshot so clients and replay tools can verify state equality
+ * in O(1) per tick by comparing against the hash the server sent.
+ *
+ * Keys are added modulo 2^64 rather than XORed so that stacked cells (a
+ * grown tail, two foods on one cell) do not cancel each other out. Keys
+ * are derived with a splitmix64 finalizer instead of a lookup table, which
+ * keeps large arenas from needing megabytes of keys.
+ */
+namespace StateHash {
+
+inline std::uint64_t mix(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Tags keep the key families apart
+constexpr std::uint64_t TAG_SEGMENT = 1ull << 56;
+constexpr std::uint64_t TAG_FOOD    = 2ull << 56;
+constexpr std::uint64_t TAG_DIR     = 3ull << 56;
+constexpr std::uint64_t TAG_DEATH   = 4ull << 56;
+constexpr std::uint64_t TAG_SCORE   = 5ull << 56;
+constexpr std::uint64_t TAG_ACTIVE  = 6ull << 56;
+
+inline std::uint64_t cellBits(int x, int y) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint16_t>(x)) << 16) |
+           static_cast<std::uint16_t>(y);
+}
+
+inline std::uint64_t segmentKey(int player, int x, int y) {
+    return mix(TAG_SEGMENT | (static_cast<std::uint64_t>(player) << 32) | cellBits(x, y));
+}
+
+inline std::uint64_t foodKey(int x, int y) {
+    return mix(TAG_FOOD | cellBits(x, y));
+}
+
+inline std::uint64_t dirKey(int player, int dir) {
+    return mix(TAG_DIR | (static_cast<std::uint64_t>(player) << 32) | static_cast<std::uint32_t>(dir));
+}
+
+inline std::uint64_t deathKey(int player) {
+    return mix(TAG_DEATH | static_cast<std::uint64_t>(player));
+}
+
+/// Multiplied by the score, so a score change adds scoreKey * delta
+inline std::uint64_t scoreKey(int player) {
+    return mix(TAG_SCORE | static_cast<std::uint64_t>(player));
+}
+
+inline std::uint64_t activeKey() {
+    return mix(TAG_ACTIVE);
+}
+
+/**
+ * @brief Full recomputation from a snapshot (O(state size))
+ */
+inline std::uint64_t compute(const Protocol::GameState& state) {
+    std::uint64_t h = state.gameActive ? activeKey() : 0;
+
+    for (const auto& p : state.players) {
+        for (const auto& s : p.body) {
+            h += segmentKey(p.id, s.x, s.y);
+        }
+        h += dirKey(p.id, static_cast<int>(p.dir));
+        h += scoreKey(p.id) * static_cast<std::uint64_t>(p.score);
+        if (!p.alive) {
+            h += deathKey(p.id);
+        }
+    }
+
+    for (const auto& f : state.food) {
+        h += foodKey(f.x, f.y);
+    }
+
+    return h;
+}
+
+} // namespace StateHash
+
+#endif // STATEHASH_H
@@ -0,0 +1,409 @@
+#include "BatchEnv.h"
+#include "BinarySnapshot.h"
+#include "Frame.h"
+#include "GameLogic.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "StateHash.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Micro-benchmarks for the simulation hot paths
+ *
+ * Built only with -DGAMESERVER_BUILD_BENCHMARKS=ON. Results are printed as
+ * plain text so runs can be diffed between commits.
+ */
+
+// Heap allocations so far; the batch env bench checks step() against it
+static std::atomic<std::uint64_t> g_allocations{0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Small deterministic generator so every run replays the same inputs
+struct BenchRng {
+    std::uint64_t state{0x9E3779B97F4A7C15ull};
+
+    std::uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<std::uint32_t>(state);
+    }
+};
+
+template <typename Logic>
+void benchTick(const char* name, int ticks) {
+    auto logic = std::make_unique<Logic>();
+    typename Logic::InputArray inputs{};
+    for (int i = 0; i < Logic::MAX_PLAYERS; ++i) {
+        inputs[i].playerId = i;
+    }
+
+    BenchRng rng;
+    logic->init(Logic::MAX_PLAYERS);
+
+    std::int64_t snakeTicks = 0;
+    Clock::duration elapsed{};
+
+    for (int t = 0; t < ticks; ++t) {
+        // Turn roughly every 8 ticks; restart once half the field is dead
+        for (auto& in : inputs) {
+            if ((rng.next() & 7) == 0) {
+                in.direction = static_cast<Protocol::Direction>(rng.next() & 3);
+            }
+        }
+        if (logic->getAliveCount() < Logic::MAX_PLAYERS / 2) {
+            logic->init(Logic::MAX_PLAYERS);
+        }
+
+        snakeTicks += logic->getAliveCount();
+
+        auto start = Clock::now();
+        logic->applyInputs(inputs);
+        logic->tick();
+        elapsed += Clock::now() - start;
+    }
+
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::cout << name << ": " << ticks << " ticks, "
+              << ns / ticks << " ns/tick, "
+              << ns * 100.0 / static_cast<double>(snakeTicks) << " ns per 100 snakes"
+              << std::endl;
+}
+
+template <typename Logic>
+void benchSaveRestore(const char* name, int cycles) {
+    auto logic = std::make_unique<Logic>();
+    typename Logic::SavedState saved;
+    logic->init(Logic::MAX_PLAYERS);
+
+    // Advance a little so bodies and food are not at their spawn layout
+    typename Logic::InputArray inputs{};
+    for (int t = 0; t < 20; ++t) {
+        logic->applyInputs(inputs);
+        logic->tick();
+    }
+
+    auto start = Clock::now();
+    for (int c = 0; c < cycles; ++c) {
+        logic->saveState(saved);
+        logic->loadState(saved);
+    }
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    const size_t bytes = sizeof(saved.state) + saved.bodies.size() * sizeof(typename Logic::Cell);
+    std::cout << name << ": " << bytes << " bytes, "
+              << cycles / ms << " save/restore cycles per ms" << std::endl;
+}
+
+template <typename Logic>
+void benchBatchEnv(const char* name, int numEnvs, int steps) {
+    using Env = BatchEnv<Logic>;
+    Env env(numEnvs, Logic::MAX_PLAYERS, 1234);
+
+    std::vector<std::uint8_t> actions(static_cast<size_t>(numEnvs) * Logic::MAX_PLAYERS);
+    std::vector<std::uint8_t> observations(static_cast<size_t>(numEnvs) * Env::OBS_SIZE);
+    std::vector<float> rewards(static_cast<size_t>(numEnvs) * Logic::MAX_PLAYERS);
+    std::vector<std::uint8_t> dones(numEnvs);
+
+    BenchRng rng;
+    env.reset(observations.data());
+
+    // Doublings of every body ring past its initial size
+    auto ringGrowths = [&env] {
+        std::uint64_t growths = 0;
+        for (int e = 0; e < env.size(); ++e) {
+            for (int p = 0; p < Logic::MAX_PLAYERS; ++p) {
+                for (int c = env.getEnv(e).getBodyCapacity(p); c > Logic::INITIAL_BODY_CAPACITY; c /= 2) {
+                    ++growths;
+                }
+            }
+        }
+        return growths;
+    };
+    const std::uint64_t growthsBefore = ringGrowths();
+
+    std::int64_t episodes = 0;
+    std::uint64_t stepAllocations = 0;
+    auto start = Clock::now();
+    for (int t = 0; t < steps; ++t) {
+        for (auto& a : actions) {
+            if ((rng.next() & 7) == 0) a = static_cast<std::uint8_t>(rng.next() & 3);
+        }
+        const std::uint64_t allocations = g_allocations.load(std::memory_order_relaxed);
+        env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+        stepAllocations += g_allocations.load(std::memory_order_relaxed) - allocations;
+        for (auto d : dones) episodes += d;
+    }
+    const double s = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // step() may only allocate to grow a body ring
+    const std::uint64_t growths = ringGrowths() - growthsBefore;
+    if (stepAllocations != growths) {
+        std::cout << name << ": ALLOCATIONS IN STEP (" << stepAllocations << " allocations, "
+                  << growths << " ring growths)" << std::endl;
+        return;
+    }
+
+    std::cout << name << ": " << numEnvs << " envs, "
+              << static_cast<double>(numEnvs) * steps / s << " game steps/s, "
+              << episodes / s << " episodes/s, "
+              << growths << " ring growths" << std::endl;
+}
+
+// The ostringstream serializer JsonWriter replaced, kept as the baseline
+std::string legacySerialize(const Protocol::GameState& state) {
+    std::ostringstream oss;
+    oss << "{\"type\":\"state\",\"active\":" << (state.gameActive ? "true" : "false");
+    oss << ",\"players\":[";
+    for (size_t i = 0; i < state.players.size(); ++i) {
+        const auto& p = state.players[i];
+        if (i > 0) oss << ",";
+        oss << "{\"id\":" << p.id
+            << ",\"alive\":" << (p.alive ? "true" : "false")
+            << ",\"dir\":" << static_cast<int>(p.dir)
+            << ",\"score\":" << p.score
+            << ",\"body\":[";
+        for (size_t j = 0; j < p.body.size(); ++j) {
+            if (j > 0) oss << ",";
+            oss << "{\"x\":" << p.body[j].x << ",\"y\":" << p.body[j].y << "}";
+        }
+        oss << "]}";
+    }
+    oss << "]";
+    oss << ",\"food\":[";
+    for (size_t i = 0; i < state.food.size(); ++i) {
+        if (i > 0) oss << ",";
+        oss << "{\"x\":" << state.food[i].x << ",\"y\":" << state.food[i].y << "}";
+    }
+    oss << "]";
+    oss << ",\"hash\":\"" << std::hex << std::setw(16) << std::setfill('0') << state.hash << "\"}\n";
+    return oss.str();
+}
+
+template <typename Logic>
+void benchSerialize(const char* name, int iterations) {
+    auto logic = std::make_unique<Logic>();
+    logic->init(Logic::MAX_PLAYERS);
+
+    typename Logic::InputArray inputs{};
+    for (int t = 0; t < 20; ++t) {
+        logic->applyInputs(inputs);
+        logic->tick();
+    }
+    const Protocol::GameState state = logic->getState();
+
+    JsonWriter writer;
+    writer.begin();
+    writeGameState(writer, state);
+    const std::string expected = legacySerialize(state);
+    if (writer.finish() != expected) {
+        std::cout << name << ": OUTPUT MISMATCH" << std::endl;
+        return;
+    }
+
+    // Keeps the optimizer from dropping the loops
+    volatile size_t sink = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += legacySerialize(state).size();
+    }
+    const double legacyNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        writer.begin();
+        writeGameState(writer, state);
+        sink += writer.finish().size();
+    }
+    const double writerNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << ": " << expected.size() << " bytes, ostringstream "
+              << legacyNs / iterations << " ns, JsonWriter " << writerNs / iterations
+              << " ns (" << legacyNs / writerNs << "x)" << std::endl;
+}
+
+template <typename Logic>
+void benchDecode(const char* name, int iterations) {
+    auto logic = std::make_unique<Logic>();
+    logic->init(Logic::MAX_PLAYERS);
+
+    typename Logic::InputArray inputs{};
+    for (int t = 0; t < 20; ++t) {
+        logic->applyInputs(inputs);
+        logic->tick();
+    }
+
+    JsonWriter writer;
+    writer.begin();
+    writeGameState(writer, logic->getState());
+    const std::string text(writer.finish());
+
+    // Round trip: decoding then re-encoding must reproduce the bytes
+    Protocol::GameState decoded;
+    ParseError error = readGameState(text, decoded);
+    writer.begin();
+    writeGameState(writer, decoded);
+    if (error != ParseError::None || writer.finish() != text ||
+        StateHash::compute(decoded) != decoded.hash) {
+        std::cout << name << ": ROUND TRIP MISMATCH (" << parseErrorName(error) << ")" << std::endl;
+        return;
+    }
+
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        readGameState(text, decoded);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << ": " << text.size() << " bytes, " << ns / iterations << " ns, "
+              << static_cast<double>(text.size()) * iterations / ns * 1000.0 << " MB/s" << std::endl;
+}
+
+template <typename Logic>
+void benchCompress(const char* name, int iterations) {
+    auto logic = std::make_unique<Logic>();
+    logic->init(Logic::MAX_PLAYERS);
+
+    typename Logic::InputArray inputs{};
+    for (int t = 0; t < 20; ++t) {
+        logic->applyInputs(inputs);
+        logic->tick();
+    }
+
+    JsonWriter writer;
+    writer.begin();
+    writeGameState(writer, logic->getState());
+    const std::string text(writer.finish());
+
+    Frame::Encoder encoder(0);
+    std::string_view frame = encoder.encode(text);
+
+    Frame::Header header;
+    std::string decoded;
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(frame.data());
+    if (!Frame::readHeader(bytes, header) ||
+        !Frame::decodePayload(header, bytes + Frame::HEADER_SIZE, decoded) || decoded != text) {
+        std::cout << name << ": ROUND TRIP MISMATCH" << std::endl;
+        return;
+    }
+
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        frame = encoder.encode(text);
+    }
+    const double encodeNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        Frame::decodePayload(header, bytes + Frame::HEADER_SIZE, decoded);
+    }
+    const double decodeNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << ": " << text.size() << " -> " << frame.size() << " bytes ("
+              << static_cast<double>(text.size()) / static_cast<double>(frame.size()) << "x), "
+              << "compress " << encodeNs / iterations << " ns, "
+              << "decompress " << decodeNs / iterations << " ns" << std::endl;
+}
+
+template <typename Logic>
+void benchBinarySnapshot(const char* name, int iterations) {
+    auto logic = std::make_unique<Logic>();
+    logic->init(Logic::MAX_PLAYERS);
+
+    // Long enough for snakes to have eaten, so tails repeat
+    BenchRng rng;
+    typename Logic::InputArray inputs{};
+    for (int t = 0; t < 60; ++t) {
+        for (int i = 0; i < Logic::MAX_PLAYERS; ++i) {
+            inputs[i].playerId = i;
+            if ((rng.next() & 7) == 0) inputs[i].direction = static_cast<Protocol::Direction>(rng.next() & 3);
+        }
+        logic->applyInputs(inputs);
+        logic->tick();
+    }
+    const Protocol::GameState state = logic->getState();
+
+    JsonWriter writer;
+    writer.begin();
+    writeGameState(writer, state);
+    const std::string json(writer.finish());
+
+    // Round trip: the decoded state must serialize to the same JSON
+    std::string binary;
+    Protocol::GameState decoded;
+    BinarySnapshot::encode(state, binary);
+    bool ok = BinarySnapshot::decode(reinterpret_cast<const std::uint8_t*>(binary.data()),
+                                     binary.size(), decoded);
+    writer.begin();
+    writeGameState(writer, decoded);
+    if (!ok || writer.finish() != json) {
+        std::cout << name << ": ROUND TRIP MISMATCH" << std::endl;
+        return;
+    }
+
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        BinarySnapshot::encode(state, binary);
+    }
+    const double encodeNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        BinarySnapshot::decode(reinterpret_cast<const std::uint8_t*>(binary.data()),
+                               binary.size(), decoded);
+    }
+    const double decodeNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::cout << name << ": JSON " << json.size() << " bytes -> " << binary.size() << " bytes ("
+              << static_cast<double>(json.size()) / static_cast<double>(binary.size()) << "x), "
+              << "encode " << encodeNs / iterations << " ns, "
+              << "decode " << decodeNs / iterations << " ns" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    benchTick<ClassicGameLogic>("tick classic (4p)", 200000);
+    benchTick<ArenaGameLogic>("tick arena (64p)", 50000);
+    benchTick<RoyaleGameLogic>("tick royale (256p)", 20000);
+    benchSaveRestore<ClassicGameLogic>("save/restore classic (4p)", 1000000);
+    benchSaveRestore<ArenaGameLogic>("save/restore arena (64p)", 20000);
+    benchSaveRestore<RoyaleGameLogic>("save/restore royale (256p)", 5000);
+    benchBatchEnv<ClassicGameLogic>("batch env classic (4p)", 1024, 2000);
+    benchBatchEnv<ArenaGameLogic>("batch env arena (64p)", 64, 500);
+    benchSerialize<ClassicGameLogic>("serialize classic (4p)", 200000);
+    benchSerialize<ArenaGameLogic>("serialize arena (64p)", 20000);
+    benchSerialize<RoyaleGameLogic>("serialize royale (256p)", 5000);
+    benchDecode<ClassicGameLogic>("decode classic (4p)", 200000);
+    benchDecode<ArenaGameLogic>("decode arena (64p)", 20000);
+    benchDecode<RoyaleGameLogic>("decode royale (256p)", 5000);
+    benchCompress<ClassicGameLogic>("compress classic (4p)", 200000);
+    benchCompress<ArenaGameLogic>("compress arena (64p)", 20000);
+    benchCompress<RoyaleGameLogic>("compress royale (256p)", 5000);
+    benchBinarySnapshot<ClassicGameLogic>("binary snapshot classic (4p)", 200000);
+    benchBinarySnapshot<ArenaGameLogic>("binary snapshot arena (64p)", 20000);
+    benchBinarySnapshot<RoyaleGameLogic>("binary snapshot royale (256p)", 5000);
+    return 0;
+}
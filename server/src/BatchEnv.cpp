@@ -0,0 +1,184 @@
+#include "BatchEnv.h"
+#include <algorithm>
+#include <cstring>
+
+template <typename Logic>
+BatchEnv<Logic>::BatchEnv(int numEnvs, int playersPerEnv, std::uint64_t seed, int numThreads)
+    : m_numEnvs(std::max(numEnvs, 0))
+    , m_playersPerEnv(std::clamp(playersPerEnv, 1, MAX_PLAYERS)) {
+    m_envs.reserve(m_numEnvs);
+    for (int i = 0; i < m_numEnvs; ++i) {
+        // Spread the base seed so neighbouring games do not share streams
+        m_envs.push_back(std::make_unique<Logic>(seed ^ (0x9E3779B97F4A7C15ull * (i + 1))));
+    }
+
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    numThreads = std::min(numThreads, std::max(m_numEnvs, 1));
+
+    // The calling thread runs chunk 0, workers run the rest
+    for (int chunk = 1; chunk < numThreads; ++chunk) {
+        m_workers.emplace_back(&BatchEnv::workerLoop, this, chunk);
+    }
+}
+
+template <typename Logic>
+BatchEnv<Logic>::~BatchEnv() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::reset(std::uint8_t* observations) {
+    m_observations = observations;
+    runJob(Job::Reset);
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::step(const std::uint8_t* actions, std::uint8_t* observations,
+                           float* rewards, std::uint8_t* dones) {
+    m_actions = actions;
+    m_observations = observations;
+    m_rewards = rewards;
+    m_dones = dones;
+    runJob(Job::Step);
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::runJob(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = job;
+        m_pending = static_cast<int>(m_workers.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this] { return m_pending == 0; });
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::workerLoop(int chunk) {
+    std::uint64_t seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) return;
+            seen = m_generation;
+        }
+
+        runChunk(chunk);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0) {
+            m_finished.notify_one();
+        }
+    }
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::runChunk(int chunk) {
+    const int chunks = static_cast<int>(m_workers.size()) + 1;
+    const int begin = static_cast<int>(static_cast<long long>(m_numEnvs) * chunk / chunks);
+    const int end = static_cast<int>(static_cast<long long>(m_numEnvs) * (chunk + 1) / chunks);
+
+    for (int i = begin; i < end; ++i) {
+        if (m_job == Job::Reset) {
+            resetEnv(i);
+        } else {
+            stepEnv(i);
+        }
+    }
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::resetEnv(int index) {
+    m_envs[index]->init(m_playersPerEnv);
+    writeObservation(index);
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::stepEnv(int index) {
+    Logic& logic = *m_envs[index];
+    const auto& state = logic.getRawState();
+    const std::uint8_t* actions = m_actions + static_cast<size_t>(index) * MAX_PLAYERS;
+    float* rewards = m_rewards + static_cast<size_t>(index) * MAX_PLAYERS;
+
+    typename Logic::InputArray inputs;
+    std::array<int, MAX_PLAYERS> prevScore;
+    std::array<int, MAX_PLAYERS> prevAlive;
+    for (int p = 0; p < MAX_PLAYERS; ++p) {
+        inputs[p].playerId = p;
+        inputs[p].direction = static_cast<Protocol::Direction>(actions[p] & 3);
+        prevScore[p] = state.score[p];
+        prevAlive[p] = state.alive[p];
+    }
+
+    logic.applyInputs(inputs);
+    logic.tick();
+
+    // +1 per food eaten, -1 on death
+    for (int p = 0; p < MAX_PLAYERS; ++p) {
+        rewards[p] = static_cast<float>(state.score[p] - prevScore[p]) / Logic::FOOD_SCORE -
+                     static_cast<float>(prevAlive[p] & ~state.alive[p] & 1);
+    }
+
+    const bool done = !logic.isGameActive();
+    m_dones[index] = done ? 1 : 0;
+    if (done) {
+        logic.init(m_playersPerEnv);
+    }
+
+    writeObservation(index);
+}
+
+template <typename Logic>
+void BatchEnv<Logic>::writeObservation(int index) {
+    const Logic& logic = *m_envs[index];
+    const auto& state = logic.getRawState();
+    std::uint8_t* obs = m_observations + static_cast<size_t>(index) * OBS_SIZE;
+    std::uint8_t* food = obs;
+    std::uint8_t* bodies = obs + OBS_PLANE;
+    std::uint8_t* heads = obs + 2 * OBS_PLANE;
+
+    std::memset(obs, 0, OBS_SIZE);
+
+    auto inGrid = [](int x, int y) {
+        return x >= 0 && y >= 0 && x < Logic::GRID_W && y < Logic::GRID_H;
+    };
+
+    for (int f = 0; f < state.foodCount; ++f) {
+        food[state.food[f].y * Logic::GRID_W + state.food[f].x] = 1;
+    }
+
+    for (int p = 0; p < state.playerCount; ++p) {
+        for (int s = 0; s < state.bodyLength[p]; ++s) {
+            const auto& c = logic.getBodyCell(p, s);
+            if (inGrid(c.x, c.y)) {
+                bodies[c.y * Logic::GRID_W + c.x] = 1;
+            }
+        }
+        if (state.alive[p]) {
+            heads[state.headY[p] * Logic::GRID_W + state.headX[p]] = 1;
+        }
+    }
+}
+
+// ============================================================
+// Explicit instantiations for the supported presets
+// ============================================================
+
+template class BatchEnv<ClassicGameLogic>;
+template class BatchEnv<ArenaGameLogic>;
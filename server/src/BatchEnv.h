@@ -0,0 +1,107 @@
+#ifndef BATCHENV_H
+#define BATCHENV_H
+
+#include "GameLogic.h"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Headless batch environment for training bots against GameLogic
+ *
+ * Steps N independent games in lockstep with a single call, split across
+ * a persistent worker pool. There is no networking and no sleeping, and
+ * callers own every buffer. The only allocations after construction are
+ * snake body rings growing while the games warm up: a ring doubles when a
+ * snake outgrows it and is never shrunk, so each player slot allocates at
+ * most a handful of times over the batch's life (see
+ * GameLogic::INITIAL_BODY_CAPACITY) and a warmed-up step allocates nothing.
+ *
+ * Buffer layouts (row-major, env index outermost):
+ *  - actions      : uint8 [numEnvs][MAX_PLAYERS], Protocol::Direction values
+ *  - observations : uint8 [numEnvs][OBS_CHANNELS][GRID_H][GRID_W], 0 or 1
+ *  - rewards      : float [numEnvs][MAX_PLAYERS]
+ *  - dones        : uint8 [numEnvs]
+ *
+ * Observation channels are food, body segments (any snake) and live heads.
+ * A game that ends during step() reports done and is reset immediately, so
+ * its observation already shows the next episode.
+ */
+template <typename Logic>
+class BatchEnv {
+public:
+    static constexpr int MAX_PLAYERS = Logic::MAX_PLAYERS;
+    static constexpr int OBS_CHANNELS = 3;
+    static constexpr int OBS_PLANE = Logic::GRID_W * Logic::GRID_H;
+    static constexpr int OBS_SIZE = OBS_CHANNELS * OBS_PLANE;
+
+    /**
+     * @param numEnvs        Number of games stepped together
+     * @param playersPerEnv  Snakes per game (clamped to MAX_PLAYERS)
+     * @param seed           Base seed; game i is seeded from seed and i
+     * @param numThreads     Threads to use, 0 for hardware concurrency
+     */
+    BatchEnv(int numEnvs, int playersPerEnv, std::uint64_t seed, int numThreads = 0);
+    ~BatchEnv();
+
+    BatchEnv(const BatchEnv&) = delete;
+    BatchEnv& operator=(const BatchEnv&) = delete;
+
+    /**
+     * @brief Start a new episode in every game and write observations
+     */
+    void reset(std::uint8_t* observations);
+
+    /**
+     * @brief Apply one action per snake, advance every game by one tick
+     */
+    void step(const std::uint8_t* actions, std::uint8_t* observations,
+              float* rewards, std::uint8_t* dones);
+
+    /**
+     * @brief Number of games in the batch
+     */
+    int size() const { return m_numEnvs; }
+
+    /**
+     * @brief Read-only access to one game (debugging, rendering)
+     */
+    const Logic& getEnv(int index) const { return *m_envs[index]; }
+
+private:
+    enum class Job { Reset, Step };
+
+    int m_numEnvs;
+    int m_playersPerEnv;
+    std::vector<std::unique_ptr<Logic>> m_envs;
+
+    // Arguments of the job currently being run by the pool
+    Job m_job{Job::Reset};
+    const std::uint8_t* m_actions{nullptr};
+    std::uint8_t* m_observations{nullptr};
+    float* m_rewards{nullptr};
+    std::uint8_t* m_dones{nullptr};
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+    std::uint64_t m_generation{0};
+    int m_pending{0};
+    bool m_stopping{false};
+
+    void runJob(Job job);
+    void workerLoop(int chunk);
+    void runChunk(int chunk);
+    void resetEnv(int index);
+    void stepEnv(int index);
+    void writeObservation(int index);
+};
+
+extern template class BatchEnv<ClassicGameLogic>;
+extern template class BatchEnv<ArenaGameLogic>;
+
+#endif // BATCHENV_H
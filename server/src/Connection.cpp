@@ -1,5 +1,5 @@
 #include "Connection.h"
-#include <cstring>
+#include <cerrno>
 
 Connection::Connection(SocketHandle socket, int id)
     : m_socket(socket), m_id(id), m_alive(true) {
@@ -9,40 +9,83 @@ Connection::~Connection() {
     close();
 }
 
-bool Connection::send(const std::string& data) {
+bool Connection::send(std::string_view data) {
     if (!m_alive) return false;
     
-    const char* buf = data.c_str();
-    size_t total = data.size();
+    // Behind a backlog: queue, keeping the stream in order
+    if (pendingBytes() > 0) {
+        if (pendingBytes() + data.size() > MAX_SEND_BACKLOG) {
+            close();
+            return false;
+        }
+        m_sendBuffer.append(data.data(), data.size());
+        return flush();
+    }
+    
+    // Usual case: straight to the socket, queueing only what it refused
     size_t sent = 0;
+    while (sent < data.size()) {
+        long result = writeSome(data.data() + sent, data.size() - sent);
+        if (result < 0) return false;
+        if (result == 0) break;
+        sent += static_cast<size_t>(result);
+    }
     
-    while (sent < total) {
-        #ifdef _WIN32
-            int result = ::send(m_socket, buf + sent, static_cast<int>(total - sent), 0);
-        #else
-            ssize_t result = ::send(m_socket, buf + sent, total - sent, 0);
-        #endif
-        
-        if (result <= 0) {
-            m_alive = false;
+    if (sent < data.size()) {
+        if (data.size() - sent > MAX_SEND_BACKLOG) {
+            close();
             return false;
         }
-        sent += result;
+        m_sendBuffer.assign(data.data() + sent, data.size() - sent);
+        m_sendPos = 0;
     }
+    return true;
+}
+
+bool Connection::flush() {
+    if (!m_alive) return false;
     
+    while (m_sendPos < m_sendBuffer.size()) {
+        long result = writeSome(m_sendBuffer.data() + m_sendPos, m_sendBuffer.size() - m_sendPos);
+        if (result < 0) return false;
+        if (result == 0) return true;
+        m_sendPos += static_cast<size_t>(result);
+    }
+    
+    m_sendBuffer.clear();
+    m_sendPos = 0;
     return true;
 }
 
-std::string Connection::receive() {
-    if (!m_alive) return "";
+long Connection::writeSome(const char* data, size_t size) {
+    #ifdef _WIN32
+        int result = ::send(m_socket, data, static_cast<int>(size), 0);
+        if (result >= 0) return result;
+        if (WSAGetLastError() == WSAEWOULDBLOCK) return 0;
+    #else
+        // No SIGPIPE when the peer has gone; the error is handled below
+        ssize_t result = ::send(m_socket, data, size, MSG_NOSIGNAL);
+        if (result >= 0) return static_cast<long>(result);
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+    #endif
+    
+    close();
+    return -1;
+}
+
+void Connection::receive(size_t maxLineSize) {
+    if (!m_alive) return;
+    
+    // Drop lines already handed out; the remainder is one partial line
+    m_recvBuffer.erase(0, m_readPos);
+    m_readPos = 0;
     
     char buffer[4096];
-    std::memset(buffer, 0, sizeof(buffer));
     
     #ifdef _WIN32
-        int result = ::recv(m_socket, buffer, sizeof(buffer) - 1, 0);
+        int result = ::recv(m_socket, buffer, sizeof(buffer), 0);
     #else
-        ssize_t result = ::recv(m_socket, buffer, sizeof(buffer) - 1, 0);
+        ssize_t result = ::recv(m_socket, buffer, sizeof(buffer), 0);
     #endif
     
     if (result <= 0) {
@@ -50,10 +93,45 @@ std::string Connection::receive() {
             // Connection closed gracefully
             m_alive = false;
         }
-        return "";
+        return;
+    }
+    
+    std::string_view incoming(buffer, static_cast<size_t>(result));
+    
+    // Skip the rest of an overlong line up to its newline
+    if (m_discardingLine) {
+        size_t newline = incoming.find('\n');
+        if (newline == std::string_view::npos) return;
+        incoming.remove_prefix(newline + 1);
+        m_discardingLine = false;
     }
     
-    return std::string(buffer, result);
+    m_recvBuffer.append(incoming.data(), incoming.size());
+    
+    // Bound memory per client: an unterminated tail may not exceed one line
+    size_t lastNewline = m_recvBuffer.rfind('\n');
+    size_t tailStart = lastNewline == std::string::npos ? 0 : lastNewline + 1;
+    if (m_recvBuffer.size() - tailStart > maxLineSize) {
+        m_recvBuffer.resize(tailStart);
+        m_discardingLine = true;
+        ++m_overflowCount;
+    }
+}
+
+bool Connection::nextLine(std::string_view& line) {
+    size_t newline = m_recvBuffer.find('\n', m_readPos);
+    if (newline == std::string::npos) return false;
+    
+    line = std::string_view(m_recvBuffer).substr(m_readPos, newline - m_readPos);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    m_readPos = newline + 1;
+    return true;
+}
+
+int Connection::takeOverflowCount() {
+    int count = m_overflowCount;
+    m_overflowCount = 0;
+    return count;
 }
 
 bool Connection::isAlive() const {
@@ -2,6 +2,7 @@
 #define CONNECTION_H
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
 #ifdef _WIN32
@@ -14,6 +15,7 @@
     #include <netinet/in.h>
     #include <arpa/inet.h>
     #include <unistd.h>
+    #include <fcntl.h>
 #endif
 
 /**
@@ -27,18 +29,53 @@ public:
         using SocketHandle = int;
     #endif
     
+    /// Unsent bytes a slow client may accumulate before it is disconnected
+    static constexpr size_t MAX_SEND_BACKLOG = 256 * 1024;
+    
     explicit Connection(SocketHandle socket, int id);
     ~Connection();
     
     /**
-     * @brief Send data to this connection
+     * @brief Send data to this connection (non-blocking)
+     *
+     * Whatever the socket does not take right away is queued behind earlier
+     * unsent bytes and written by later flush() calls, so messages are
+     * never cut. Returns false once the connection is dead: a hard socket
+     * error, or a backlog past MAX_SEND_BACKLOG.
+     */
+    bool send(std::string_view data);
+    
+    /**
+     * @brief Write as much of the queued backlog as the socket takes
+     */
+    bool flush();
+    
+    /**
+     * @brief Bytes queued by send() and not written yet
+     */
+    size_t pendingBytes() const { return m_sendBuffer.size() - m_sendPos; }
+    
+    /**
+     * @brief Read pending bytes into the receive buffer (non-blocking)
+     *
+     * Messages are '\n'-terminated lines; a partial line stays buffered
+     * until the rest arrives. A line that grows past maxLineSize without a
+     * newline is dropped up to its newline and counted in the overflow
+     * counter.
+     */
+    void receive(size_t maxLineSize);
+    
+    /**
+     * @brief Take the next complete line, without its newline
+     *
+     * The view stays valid until the next receive().
      */
-    bool send(const std::string& data);
+    bool nextLine(std::string_view& line);
     
     /**
-     * @brief Receive data from this connection (non-blocking)
+     * @brief Lines dropped for exceeding maxLineSize since the last call
      */
-    std::string receive();
+    int takeOverflowCount();
     
     /**
      * @brief Check if connection is still alive
@@ -65,11 +102,40 @@ public:
      */
     int getPlayerId() const { return m_playerId; }
     
+    /**
+     * @brief How server messages are sent, as negotiated by the client hello
+     */
+    enum class Encoding {
+        JsonLines,      // '\n'-terminated JSON (default)
+        JsonFrames,     // Frame with JSON payload, compressed when large
+        BinaryFrames    // Frame with BinarySnapshot payload
+    };
+    
+    void setEncoding(Encoding encoding) { m_encoding = encoding; }
+    Encoding getEncoding() const { return m_encoding; }
+    
 private:
     SocketHandle m_socket;
     int m_id;
     int m_playerId{-1};
     bool m_alive{true};
+    Encoding m_encoding{Encoding::JsonLines};
+    
+    // Bytes the socket would not take yet; [m_sendPos, end) is left to write
+    std::string m_sendBuffer;
+    size_t m_sendPos{0};
+    
+    // Received bytes; [m_readPos, end) has not been returned by nextLine() yet
+    std::string m_recvBuffer;
+    size_t m_readPos{0};
+    bool m_discardingLine{false};
+    int m_overflowCount{0};
+    
+    /**
+     * @brief One non-blocking send: bytes written, 0 when the socket is
+     * full, or -1 after a hard error (the connection is then closed)
+     */
+    long writeSome(const char* data, size_t size);
 };
 
 #endif // CONNECTION_H
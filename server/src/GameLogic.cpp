@@ -1,184 +1,447 @@
 #include "GameLogic.h"
+#include "Profiler.h"
+#include "StateHash.h"
 #include <algorithm>
+#include <random>
+
+template <int GridW, int GridH, int MaxPlayers>
+GameLogic<GridW, GridH, MaxPlayers>::GameLogic()
+    : GameLogic((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}()) {
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+GameLogic<GridW, GridH, MaxPlayers>::GameLogic(std::uint64_t seed) {
+    m_state.rng = seed;
+    for (auto& body : m_bodies) {
+        body.assign(INITIAL_BODY_CAPACITY, Cell{});
+    }
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::init(int playerCount) {
+    // Everything but the RNG restarts; body rings keep their size and are
+    // only read up to bodyLength, so they need no clearing
+    m_state.headX.fill(0);
+    m_state.headY.fill(0);
+    m_state.dir.fill(static_cast<int>(Protocol::Direction::Right));
+    m_state.alive.fill(0);
+    m_state.score.fill(0);
+    m_state.bodyLength.fill(0);
+    m_bodyHead.fill(0);
+    m_state.foodCount = 0;
+    m_state.playerCount = 0;
+    m_state.gameActive = true;
+    m_foodAt.fill(0);
 
-GameLogic::GameLogic() : m_rng(std::random_device{}()) {
-}
-
-void GameLogic::init(int playerCount) {
-    m_players.clear();
-    m_food.clear();
-    m_gameActive = true;
-    
-    // Starting positions for up to 4 players
-    static std::array<Protocol::Vec2, 4> starts{
-        Protocol::Vec2{10, 10}, 
-        Protocol::Vec2{50, 10}, 
-        Protocol::Vec2{10, 30}, 
-        Protocol::Vec2{50, 30}
-    };
-    
-    static std::array<Protocol::Direction, 4> dirs{
-        Protocol::Direction::Right, 
-        Protocol::Direction::Left, 
-        Protocol::Direction::Right, 
-        Protocol::Direction::Left
-    };
-    
     playerCount = std::min(playerCount, MAX_PLAYERS);
-    
+
     for (int i = 0; i < playerCount; ++i) {
-        InternalPlayerState p;
-        p.id = i;
-        p.dir = dirs[i];
-        p.alive = true;
-        p.score = 0;
-        
-        Protocol::Vec2 head = starts[i];
-        p.body.push_back(head);
-        
-        // Add initial body segments
-        for (int s = 1; s < 3; ++s) {
-            Protocol::Vec2 segment = head;
-            switch (p.dir) {
+        Cell head;
+        Protocol::Direction dir;
+        spawnPose(i, head, dir);
+
+        m_state.headX[i] = head.x;
+        m_state.headY[i] = head.y;
+        m_state.dir[i] = static_cast<int>(dir);
+        m_state.alive[i] = 1;
+
+        // Initial body of 3 cells, head last so it lands on m_bodyHead
+        for (int s = 2; s >= 0; --s) {
+            Cell segment = head;
+            switch (dir) {
                 case Protocol::Direction::Right: segment.x -= s; break;
                 case Protocol::Direction::Left:  segment.x += s; break;
                 case Protocol::Direction::Up:    segment.y += s; break;
                 case Protocol::Direction::Down:  segment.y -= s; break;
             }
-            p.body.push_back(segment);
+            m_bodies[i][2 - s] = segment;
         }
-        
-        m_players.push_back(p);
+        m_bodyHead[i] = 2;
+        m_state.bodyLength[i] = 3;
+
+        ++m_state.playerCount;
         spawnFood();
     }
+
+    rebuildIndexes();
+    m_state.hash = computeHash();
 }
 
-void GameLogic::applyInputs(const std::array<Protocol::InputCommand, MAX_PLAYERS>& inputs) {
-    for (auto& p : m_players) {
-        if (!p.alive) continue;
-        
-        const auto& cmd = inputs[p.id];
-        if (!isOpposite(p.dir, cmd.direction)) {
-            p.dir = cmd.direction;
-        }
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::applyInputs(const InputArray& inputs) {
+    std::uint64_t hashDelta = 0;
+
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        const int current = m_state.dir[i];
+        const int wanted = static_cast<int>(inputs[i].direction);
+        // Up/Down and Left/Right differ only in their lowest bit
+        const bool opposite = (current ^ wanted) == 1;
+        const int next = (m_state.alive[i] && !opposite) ? wanted : current;
+        m_state.dir[i] = next;
+        hashDelta += StateHash::dirKey(i, next) - StateHash::dirKey(i, current);
     }
+
+    m_state.hash += hashDelta;
 }
 
-void GameLogic::tick() {
-    if (!m_gameActive) return;
-    
-    movePlayers();
-    resolveFood();
-    resolveCollisions();
-    
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::tick() {
+    if (!m_state.gameActive) return;
+
+    {
+        PROFILE_SCOPE(Profiler::Phase::TickMove);
+        movePlayers();
+    }
+    {
+        PROFILE_SCOPE(Profiler::Phase::TickFood);
+        resolveFood();
+    }
+    {
+        PROFILE_SCOPE(Profiler::Phase::TickCollisions);
+        resolveCollisions();
+    }
+
     // Check if game should end (all players dead)
     if (getAliveCount() == 0) {
-        m_gameActive = false;
+        m_state.gameActive = false;
+        m_state.hash -= StateHash::activeKey();
     }
 }
 
-Protocol::GameState GameLogic::getState() const {
+template <int GridW, int GridH, int MaxPlayers>
+Protocol::GameState GameLogic<GridW, GridH, MaxPlayers>::getState() const {
     Protocol::GameState state;
-    state.gameActive = m_gameActive;
-    state.food = m_food;
-    
-    for (const auto& p : m_players) {
+    state.gameActive = m_state.gameActive;
+    state.hash = m_state.hash;
+    state.food.reserve(m_state.foodCount);
+    for (int f = 0; f < m_state.foodCount; ++f) {
+        state.food.push_back({m_state.food[f].x, m_state.food[f].y});
+    }
+    state.players.reserve(m_state.playerCount);
+
+    for (int i = 0; i < m_state.playerCount; ++i) {
         Protocol::PlayerState ps;
-        ps.id = p.id;
-        ps.alive = p.alive;
-        ps.dir = p.dir;
-        ps.score = p.score;
-        ps.body = std::vector<Protocol::Vec2>(p.body.begin(), p.body.end());
-        state.players.push_back(ps);
-    }
-    
+        ps.id = i;
+        ps.alive = m_state.alive[i] != 0;
+        ps.dir = static_cast<Protocol::Direction>(m_state.dir[i]);
+        ps.score = m_state.score[i];
+        ps.body.reserve(m_state.bodyLength[i]);
+        for (int s = 0; s < m_state.bodyLength[i]; ++s) {
+            const Cell& c = getBodyCell(i, s);
+            ps.body.push_back({c.x, c.y});
+        }
+        state.players.push_back(std::move(ps));
+    }
+
     return state;
 }
 
-bool GameLogic::isGameActive() const {
-    return m_gameActive;
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::saveState(SavedState& out) const {
+    out.state = m_state;
+
+    int total = 0;
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        total += m_state.bodyLength[i];
+    }
+    out.bodies.resize(total);
+
+    // Unroll each ring tail first; bodies are short, so a plain loop beats
+    // a memmove call per run
+    Cell* cells = out.bodies.data();
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        const Cell* body = m_bodies[i].data();
+        const int length = m_state.bodyLength[i];
+        const int mask = static_cast<int>(m_bodies[i].size()) - 1;
+        const int tail = m_bodyHead[i] - length + 1;
+        for (int s = 0; s < length; ++s) {
+            *cells++ = body[(tail + s) & mask];
+        }
+    }
 }
 
-int GameLogic::getAliveCount() const {
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::loadState(const SavedState& in) {
+    // Take the current bodies and food off the indexes and put the restored
+    // ones on, instead of clearing and refilling both grids
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        const Cell* body = m_bodies[i].data();
+        const int mask = static_cast<int>(m_bodies[i].size()) - 1;
+        const int head = m_bodyHead[i];
+        for (int s = 0; s < m_state.bodyLength[i]; ++s) {
+            vacate(body[(head - s) & mask]);
+        }
+    }
+    for (int f = 0; f < m_state.foodCount; ++f) {
+        m_foodAt[m_state.food[f].y * GRID_W + m_state.food[f].x] = 0;
+    }
+
+    m_state = in.state;
+
+    // Restored rings start at index 0, tail first
+    const Cell* cells = in.bodies.data();
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        const int length = m_state.bodyLength[i];
+        std::vector<Cell>& body = m_bodies[i];
+        if (length > static_cast<int>(body.size())) {
+            body.assign(bodyCapacity(length), Cell{});
+        }
+        for (int s = 0; s < length; ++s) {
+            body[s] = cells[s];
+            occupy(cells[s]);
+        }
+        m_bodyHead[i] = length - 1;
+        cells += length;
+    }
+    for (int f = 0; f < m_state.foodCount; ++f) {
+        m_foodAt[m_state.food[f].y * GRID_W + m_state.food[f].x] = static_cast<std::uint16_t>(f + 1);
+    }
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+bool GameLogic<GridW, GridH, MaxPlayers>::isGameActive() const {
+    return m_state.gameActive;
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+int GameLogic<GridW, GridH, MaxPlayers>::getAliveCount() const {
     int count = 0;
-    for (const auto& p : m_players) {
-        if (p.alive) count++;
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        count += m_state.alive[i];
     }
     return count;
 }
 
-void GameLogic::spawnFood() {
-    std::uniform_int_distribution<> x(0, GRID_W - 1);
-    std::uniform_int_distribution<> y(0, GRID_H - 1);
-    m_food.push_back({x(m_rng), y(m_rng)});
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::spawnFood() {
+    if (m_state.foodCount >= MAX_PLAYERS) return;
+    const Cell cell = randomFoodFreeCell();
+    m_state.food[m_state.foodCount++] = cell;
+    m_foodAt[cell.y * GRID_W + cell.x] = static_cast<std::uint16_t>(m_state.foodCount);
 }
 
-void GameLogic::movePlayers() {
-    for (auto& p : m_players) {
-        if (!p.alive) continue;
-        
-        Protocol::Vec2 head = p.body.front();
-        
-        switch (p.dir) {
-            case Protocol::Direction::Up:    head.y--; break;
-            case Protocol::Direction::Down:  head.y++; break;
-            case Protocol::Direction::Left:  head.x--; break;
-            case Protocol::Direction::Right: head.x++; break;
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::movePlayers() {
+    // Vectorized pass: advance every live head one cell along its direction
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        const int d = m_state.dir[i];
+        const int dx = (d == static_cast<int>(Protocol::Direction::Right)) -
+                       (d == static_cast<int>(Protocol::Direction::Left));
+        const int dy = (d == static_cast<int>(Protocol::Direction::Down)) -
+                       (d == static_cast<int>(Protocol::Direction::Up));
+        m_state.headX[i] += dx * m_state.alive[i];
+        m_state.headY[i] += dy * m_state.alive[i];
+    }
+
+    // Scalar pass: shift the body rings and keep the occupancy grid in sync
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        if (!m_state.alive[i]) continue;
+
+        const Cell tail = bodyCell(i, m_state.bodyLength[i] - 1);
+        vacate(tail);
+
+        const int head = (m_bodyHead[i] + 1) & (static_cast<int>(m_bodies[i].size()) - 1);
+        const Cell cell{static_cast<std::int16_t>(m_state.headX[i]),
+                        static_cast<std::int16_t>(m_state.headY[i])};
+        m_bodies[i][head] = cell;
+        m_bodyHead[i] = head;
+        occupy(cell);
+
+        m_state.hash += StateHash::segmentKey(i, cell.x, cell.y) -
+                        StateHash::segmentKey(i, tail.x, tail.y);
+    }
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::resolveFood() {
+    // O(1) lookup per head through the food cell index
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        if (!m_state.alive[i] || !inBounds(m_state.headX[i], m_state.headY[i])) continue;
+
+        const int cellIndex = m_state.headY[i] * GRID_W + m_state.headX[i];
+        const int slot = m_foodAt[cellIndex];
+        if (slot == 0) continue;
+
+        if (m_state.bodyLength[i] == static_cast<int>(m_bodies[i].size())) {
+            growBody(i);
         }
-        
-        p.body.push_front(head);
-        p.body.pop_back();
+        const Cell tail = bodyCell(i, m_state.bodyLength[i] - 1);
+        ++m_state.bodyLength[i];
+        bodyCell(i, m_state.bodyLength[i] - 1) = tail;
+        occupy(tail);
+        m_state.hash += StateHash::segmentKey(i, tail.x, tail.y);
+        m_state.score[i] += FOOD_SCORE;
+        m_state.hash += StateHash::scoreKey(i) * FOOD_SCORE;
+
+        // O(1) relocation: clear the old cell, claim a free one
+        Cell& food = m_state.food[slot - 1];
+        const Cell eaten = food;
+        m_foodAt[cellIndex] = 0;
+        food = randomFoodFreeCell();
+        m_foodAt[food.y * GRID_W + food.x] = static_cast<std::uint16_t>(slot);
+        m_state.hash += StateHash::foodKey(food.x, food.y) -
+                        StateHash::foodKey(eaten.x, eaten.y);
     }
 }
 
-void GameLogic::resolveFood() {
-    for (auto& p : m_players) {
-        if (!p.alive) continue;
-        
-        for (auto& f : m_food) {
-            if (p.body.front().x == f.x && p.body.front().y == f.y) {
-                p.body.push_back(p.body.back());
-                p.score += 10;
-                f = randomCell();
-            }
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::resolveCollisions() {
+    std::uint64_t hashDelta = 0;
+
+    // Vectorized pass: wall collision
+    for (int i = 0; i < MAX_PLAYERS; ++i) {
+        const int inside = static_cast<int>(inBounds(m_state.headX[i], m_state.headY[i]));
+        hashDelta += StateHash::deathKey(i) * static_cast<std::uint64_t>(m_state.alive[i] & (inside ^ 1));
+        m_state.alive[i] &= inside;
+    }
+
+    // Snake collision (self and others): the head counts once in its own
+    // cell, so any further segment there belongs to a body it ran into.
+    // Deaths leave bodies in place, so the order players die in is irrelevant.
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        if (!m_state.alive[i]) continue;
+
+        if (m_occupancy[m_state.headY[i] * GRID_W + m_state.headX[i]] > 1) {
+            m_state.alive[i] = 0;
+            hashDelta += StateHash::deathKey(i);
         }
     }
+
+    m_state.hash += hashDelta;
 }
 
-void GameLogic::resolveCollisions() {
-    for (auto& p : m_players) {
-        if (!p.alive) continue;
-        
-        const Protocol::Vec2& h = p.body.front();
-        
-        // Wall collision
-        if (h.x < 0 || h.y < 0 || h.x >= GRID_W || h.y >= GRID_H) {
-            p.alive = false;
-            continue;
+template <int GridW, int GridH, int MaxPlayers>
+typename GameLogic<GridW, GridH, MaxPlayers>::Cell GameLogic<GridW, GridH, MaxPlayers>::randomCell() {
+    // Multiply-shift maps each 32-bit half onto [0, size) without a divide
+    const std::uint64_t r = nextRandom();
+    const auto x = static_cast<std::int16_t>(((r & 0xFFFFFFFFu) * GRID_W) >> 32);
+    const auto y = static_cast<std::int16_t>(((r >> 32) * GRID_H) >> 32);
+    return {x, y};
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+typename GameLogic<GridW, GridH, MaxPlayers>::Cell GameLogic<GridW, GridH, MaxPlayers>::randomFoodFreeCell() {
+    // Food never stacks; with at most MAX_PLAYERS items this rarely rerolls
+    Cell cell = randomCell();
+    while (m_foodAt[cell.y * GRID_W + cell.x] != 0) {
+        cell = randomCell();
+    }
+    return cell;
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+std::uint64_t GameLogic<GridW, GridH, MaxPlayers>::nextRandom() {
+    // splitmix64: one word of state, so it lives inside State
+    std::uint64_t z = (m_state.rng += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::rebuildIndexes() {
+    m_foodAt.fill(0);
+    for (int f = 0; f < m_state.foodCount; ++f) {
+        const Cell& food = m_state.food[f];
+        m_foodAt[food.y * GRID_W + food.x] = static_cast<std::uint16_t>(f + 1);
+    }
+
+    m_occupancy.fill(0);
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        for (int s = 0; s < m_state.bodyLength[i]; ++s) {
+            occupy(getBodyCell(i, s));
         }
-        
-        // Snake collision (self and others)
-        for (const auto& other : m_players) {
-            for (size_t i = (&other == &p ? 1 : 0); i < other.body.size(); ++i) {
-                if (h.x == other.body[i].x && h.y == other.body[i].y) {
-                    p.alive = false;
-                    break;
-                }
-            }
-            if (!p.alive) break;
+    }
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::growBody(int player) {
+    // Doubling keeps growth allocations to a handful per snake; the ring is
+    // unrolled tail first so the head lands on the last live cell
+    const int length = m_state.bodyLength[player];
+    std::vector<Cell> grown(bodyCapacity(length + 1));
+    for (int s = 0; s < length; ++s) {
+        grown[length - 1 - s] = getBodyCell(player, s);
+    }
+    m_bodies[player].swap(grown);
+    m_bodyHead[player] = length - 1;
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+int GameLogic<GridW, GridH, MaxPlayers>::bodyCapacity(int length) {
+    int capacity = INITIAL_BODY_CAPACITY;
+    while (capacity < length) capacity *= 2;
+    return capacity;
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+std::uint64_t GameLogic<GridW, GridH, MaxPlayers>::computeHash() const {
+    // Same sum as StateHash::compute(), read straight from the flat state
+    std::uint64_t h = m_state.gameActive ? StateHash::activeKey() : 0;
+
+    for (int i = 0; i < m_state.playerCount; ++i) {
+        for (int s = 0; s < m_state.bodyLength[i]; ++s) {
+            const Cell& c = getBodyCell(i, s);
+            h += StateHash::segmentKey(i, c.x, c.y);
+        }
+        h += StateHash::dirKey(i, m_state.dir[i]);
+        h += StateHash::scoreKey(i) * static_cast<std::uint64_t>(m_state.score[i]);
+        if (!m_state.alive[i]) {
+            h += StateHash::deathKey(i);
         }
     }
+
+    for (int f = 0; f < m_state.foodCount; ++f) {
+        h += StateHash::foodKey(m_state.food[f].x, m_state.food[f].y);
+    }
+
+    return h;
 }
 
-bool GameLogic::isOpposite(Protocol::Direction a, Protocol::Direction b) const {
-    return (a == Protocol::Direction::Up && b == Protocol::Direction::Down) ||
-           (a == Protocol::Direction::Down && b == Protocol::Direction::Up) ||
-           (a == Protocol::Direction::Left && b == Protocol::Direction::Right) ||
-           (a == Protocol::Direction::Right && b == Protocol::Direction::Left);
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::occupy(Cell cell) {
+    if (inBounds(cell.x, cell.y)) {
+        ++m_occupancy[cell.y * GRID_W + cell.x];
+    }
+}
+
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::vacate(Cell cell) {
+    if (inBounds(cell.x, cell.y)) {
+        --m_occupancy[cell.y * GRID_W + cell.x];
+    }
 }
 
-Protocol::Vec2 GameLogic::randomCell() {
-    std::uniform_int_distribution<> x(0, GRID_W - 1);
-    std::uniform_int_distribution<> y(0, GRID_H - 1);
-    return {x(m_rng), y(m_rng)};
+template <int GridW, int GridH, int MaxPlayers>
+typename GameLogic<GridW, GridH, MaxPlayers>::Cell&
+GameLogic<GridW, GridH, MaxPlayers>::bodyCell(int player, int segment) {
+    std::vector<Cell>& body = m_bodies[player];
+    return body[(m_bodyHead[player] - segment) & (static_cast<int>(body.size()) - 1)];
 }
+
+template <int GridW, int GridH, int MaxPlayers>
+void GameLogic<GridW, GridH, MaxPlayers>::spawnPose(int index, Cell& head, Protocol::Direction& dir) {
+    int column = 0;
+
+    if constexpr (MAX_PLAYERS <= 4) {
+        // Classic quadrant starts, (10,10) (50,10) (10,30) (50,30) on a 60x40 grid
+        column = index % 2;
+        head.x = column == 0 ? GRID_W / 6 : GRID_W - GRID_W / 6;
+        head.y = index < 2 ? GRID_H / 4 : GRID_H - GRID_H / 4;
+    } else {
+        column = index % SPAWN_COLS;
+        head.x = static_cast<std::int16_t>(column * SPAWN_CELL_W + SPAWN_CELL_W / 2);
+        head.y = static_cast<std::int16_t>((index / SPAWN_COLS) * SPAWN_CELL_H + SPAWN_CELL_H / 2);
+    }
+
+    // Alternate columns face each other so initial bodies stay in the arena
+    dir = column % 2 == 0 ? Protocol::Direction::Right : Protocol::Direction::Left;
+}
+
+// ============================================================
+// Explicit instantiations for the supported presets
+// ============================================================
+
+template class GameLogic<60, 40, 4>;
+template class GameLogic<240, 160, 64>;
+template class GameLogic<320, 320, 256>;
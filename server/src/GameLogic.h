@@ -3,71 +3,235 @@
 
 #include "Protocol.h"
 #include <array>
-#include <deque>
-#include <random>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
 
 /**
  * @brief Game logic implementation (extracted from snake.cpp)
  * Handles all game rules, collision detection, and state updates
+ *
+ * The arena size and player cap are template parameters so every bound
+ * check folds to a constant and player/food storage is sized per preset.
+ * Only the presets instantiated in GameLogic.cpp are available.
  */
+template <int GridW, int GridH, int MaxPlayers>
 class GameLogic {
 public:
-    static constexpr int GRID_W = 60;
-    static constexpr int GRID_H = 40;
-    static constexpr int MAX_PLAYERS = 4;
-    
+    static constexpr int GRID_W = GridW;
+    static constexpr int GRID_H = GridH;
+    static constexpr int MAX_PLAYERS = MaxPlayers;
+
+    /// Cells allocated per body ring up front. A ring doubles (one
+    /// allocation, inside tick()) when its snake outgrows it and keeps its
+    /// size across init(), so each player slot allocates at most
+    /// log2(arena cells / INITIAL_BODY_CAPACITY) times over its lifetime.
+    static constexpr int INITIAL_BODY_CAPACITY = 16;
+
+    /// Score awarded per food eaten
+    static constexpr int FOOD_SCORE = 10;
+
+    static_assert(GRID_W > 0 && GRID_H > 0, "Grid must not be empty");
+    static_assert(GRID_W < 32767 && GRID_H < 32767, "Cells are stored as 16-bit coordinates");
+    static_assert(MAX_PLAYERS > 0, "At least one player is required");
+    // A live body covers distinct cells except one grown tail repeat and a
+    // dead head; bodies only share a cell where a head ran into one
+    static_assert(GRID_W * GRID_H + 2 <= static_cast<long long>(Protocol::MAX_BODY_LENGTH),
+                  "Snapshot decoders would reject the longest body");
+    static_assert(GRID_W * GRID_H + 3LL * MAX_PLAYERS <= static_cast<long long>(Protocol::MAX_SNAPSHOT_CELLS),
+                  "Snapshot decoders would reject a full arena");
+    static_assert((INITIAL_BODY_CAPACITY & (INITIAL_BODY_CAPACITY - 1)) == 0,
+                  "Body rings are indexed with a mask");
+    static_assert(INITIAL_BODY_CAPACITY >= 3, "init() lays out 3-cell bodies without growing the rings");
+
+    using InputArray = std::array<Protocol::InputCommand, MAX_PLAYERS>;
+
+    /// Body cell; a dead snake's head may sit one cell outside the grid
+    struct Cell {
+        std::int16_t x;
+        std::int16_t y;
+    };
+
+    /**
+     * @brief Simulation state except body cells, as one flat, trivially
+     * copyable block
+     *
+     * Per-player fields are parallel arrays (structure of arrays) so the
+     * per-tick passes are straight loops the compiler vectorizes. Passes run
+     * over all MAX_PLAYERS slots; unused slots stay dead (alive == 0).
+     * Body cells live in per-player rings sized to the snake (getBodyCell()).
+     */
+    struct State {
+        alignas(64) std::array<int, MAX_PLAYERS> headX;
+        alignas(64) std::array<int, MAX_PLAYERS> headY;
+        alignas(64) std::array<int, MAX_PLAYERS> dir;
+        alignas(64) std::array<int, MAX_PLAYERS> alive;
+        alignas(64) std::array<int, MAX_PLAYERS> score;
+        alignas(64) std::array<int, MAX_PLAYERS> bodyLength;
+        std::array<Cell, MAX_PLAYERS> food;
+        int foodCount;
+        int playerCount;
+        bool gameActive;
+        std::uint64_t rng;
+        std::uint64_t hash;  // see StateHash.h, maintained incrementally
+    };
+
+    static_assert(std::is_trivially_copyable<State>::value,
+                  "State must stay memcpy-able for save/restore");
+
+    /**
+     * @brief Full simulation state captured by saveState()
+     *
+     * bodies holds only the live segments, tail first, player after player,
+     * so its size follows the snakes rather than the arena. Reuse one
+     * instance: once its vector has grown, saving does not allocate.
+     */
+    struct SavedState {
+        State state;
+        std::vector<Cell> bodies;
+    };
+
     GameLogic();
-    
+
+    /**
+     * @brief Construct with a fixed RNG seed (reproducible runs, bots)
+     */
+    explicit GameLogic(std::uint64_t seed);
+
     /**
      * @brief Initialize a new game with specified number of players
      */
     void init(int playerCount);
-    
+
     /**
      * @brief Apply input commands from players
      */
-    void applyInputs(const std::array<Protocol::InputCommand, MAX_PLAYERS>& inputs);
-    
+    void applyInputs(const InputArray& inputs);
+
     /**
      * @brief Update game state (move snakes, check collisions, etc.)
      */
     void tick();
-    
+
     /**
      * @brief Get current game state for broadcasting
      */
     Protocol::GameState getState() const;
-    
+
+    /**
+     * @brief Copy the full simulation state (including the RNG) into out
+     */
+    void saveState(SavedState& out) const;
+
+    /**
+     * @brief Restore a state captured by saveState()
+     *
+     * Costs a copy of State and of the live segments plus an index update
+     * per segment; nothing proportional to the arena size.
+     */
+    void loadState(const SavedState& in);
+
+    /**
+     * @brief Read-only view of the live simulation state (no copy)
+     */
+    const State& getRawState() const { return m_state; }
+
+    /**
+     * @brief Cells allocated in a player's body ring (a power of two)
+     */
+    int getBodyCapacity(int player) const { return static_cast<int>(m_bodies[player].size()); }
+
+    /**
+     * @brief Body segment of a player, segment 0 being the head
+     */
+    const Cell& getBodyCell(int player, int segment) const {
+        const std::vector<Cell>& body = m_bodies[player];
+        return body[(m_bodyHead[player] - segment) & (static_cast<int>(body.size()) - 1)];
+    }
+
+    /**
+     * @brief Incremental 64-bit hash of the current state (StateHash.h)
+     */
+    std::uint64_t getStateHash() const { return m_state.hash; }
+
     /**
      * @brief Check if game is active
      */
     bool isGameActive() const;
-    
+
     /**
      * @brief Get number of alive players
      */
     int getAliveCount() const;
-    
+
 private:
-    struct InternalPlayerState {
-        int id{};
-        bool alive{true};
-        Protocol::Direction dir{Protocol::Direction::Right};
-        std::deque<Protocol::Vec2> body;
-        int score{0};
-    };
-    
-    std::vector<InternalPlayerState> m_players;
-    std::vector<Protocol::Vec2> m_food;
-    bool m_gameActive{false};
-    std::mt19937 m_rng;
-    
+    // Spawn lattice used when more than 4 players share the arena
+    static constexpr int spawnColumns() {
+        int cols = 1;
+        while (cols * cols < MAX_PLAYERS) ++cols;
+        return cols;
+    }
+    static constexpr int SPAWN_COLS = spawnColumns();
+    static constexpr int SPAWN_ROWS = (MAX_PLAYERS + SPAWN_COLS - 1) / SPAWN_COLS;
+    static constexpr int SPAWN_CELL_W = GRID_W / SPAWN_COLS;
+    static constexpr int SPAWN_CELL_H = GRID_H / SPAWN_ROWS;
+
+    static_assert(MAX_PLAYERS <= 4 || (SPAWN_CELL_W >= 6 && SPAWN_CELL_H >= 1),
+                  "Grid too small to spawn MaxPlayers snakes");
+
+    State m_state{};
+
+    // Body rings (power-of-two sizes), head at m_bodyHead, segments walking
+    // backwards for bodyLength cells
+    std::array<std::vector<Cell>, MAX_PLAYERS> m_bodies;
+    std::array<int, MAX_PLAYERS> m_bodyHead{};
+
+    // Cell indexes derived from the state, rebuilt by init() and updated
+    // segment by segment by loadState():
+    // body segments (alive or dead snakes) covering each in-bounds cell, and
+    // 1 + index into State::food of the food on each cell (0 when empty)
+    std::array<std::uint16_t, GRID_W * GRID_H> m_occupancy{};
+    std::array<std::uint16_t, GRID_W * GRID_H> m_foodAt{};
+
+    static_assert(MAX_PLAYERS < 65535, "Food indexes are stored in 16 bits");
+    static_assert(GRID_W * GRID_H > MAX_PLAYERS, "Food needs a free cell to move to");
+
     void spawnFood();
     void movePlayers();
     void resolveFood();
     void resolveCollisions();
-    bool isOpposite(Protocol::Direction a, Protocol::Direction b) const;
-    Protocol::Vec2 randomCell();
+    Cell randomCell();
+    Cell randomFoodFreeCell();
+    std::uint64_t nextRandom();
+    void rebuildIndexes();
+    void growBody(int player);
+    static int bodyCapacity(int length);
+    std::uint64_t computeHash() const;
+    void occupy(Cell cell);
+    void vacate(Cell cell);
+    Cell& bodyCell(int player, int segment);
+    static constexpr bool inBounds(int x, int y) {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(GRID_W) &&
+               static_cast<unsigned>(y) < static_cast<unsigned>(GRID_H);
+    }
+    static void spawnPose(int index, Cell& head, Protocol::Direction& dir);
 };
 
+// ============================================================
+// Presets (explicitly instantiated in GameLogic.cpp)
+// ============================================================
+
+/// Original 60x40 arena for up to 4 players
+using ClassicGameLogic = GameLogic<60, 40, 4>;
+
+/// Large 240x160 arena for up to 64 players
+using ArenaGameLogic = GameLogic<240, 160, 64>;
+
+/// Battle-royale 320x320 arena for up to 256 players (allocate on the heap)
+using RoyaleGameLogic = GameLogic<320, 320, 256>;
+
+extern template class GameLogic<60, 40, 4>;
+extern template class GameLogic<240, 160, 64>;
+extern template class GameLogic<320, 320, 256>;
+
 #endif // GAMELOGIC_H
@@ -1,6 +1,5 @@
 #include "GameServer.h"
 #include <iostream>
-#include <sstream>
 #include <algorithm>
 #include <string>
 
@@ -18,7 +17,7 @@ GameServer::GameServer(int port) : m_port(port) {
     #endif
     
     // Initialize pending inputs
-    for (int i = 0; i < GameLogic::MAX_PLAYERS; ++i) {
+    for (int i = 0; i < Logic::MAX_PLAYERS; ++i) {
         m_pendingInputs[i].playerId = i;
         m_pendingInputs[i].direction = Protocol::Direction::Right;
     }
@@ -179,7 +178,7 @@ void GameServer::acceptLoop() {
         
         std::lock_guard<std::mutex> lock(m_connectionsMutex);
         
-        if (m_connections.size() >= GameLogic::MAX_PLAYERS) {
+        if (m_connections.size() >= Logic::MAX_PLAYERS) {
             std::cout << "Max connections reached, rejecting client" << std::endl;
             #ifdef _WIN32
                 closesocket(clientSocket);
@@ -188,7 +187,13 @@ void GameServer::acceptLoop() {
             #endif
             continue;
         }
-        
+
+        // Accepted sockets only inherit non-blocking mode on Windows
+        #ifndef _WIN32
+            int clientFlags = fcntl(clientSocket, F_GETFL, 0);
+            fcntl(clientSocket, F_SETFL, clientFlags | O_NONBLOCK);
+        #endif
+
         int connId = m_connections.size();
         auto conn = std::make_unique<Connection>(clientSocket, connId);
         conn->setPlayerId(connId);
@@ -198,8 +203,8 @@ void GameServer::acceptLoop() {
         
         // Start game if we have at least one player and game not started
         if (m_connections.size() == 1 && !m_gameLogic.isGameActive()) {
-            m_gameLogic.init(GameLogic::MAX_PLAYERS);
-            std::cout << "Game initialized with " << GameLogic::MAX_PLAYERS << " players" << std::endl;
+            m_gameLogic.init(Logic::MAX_PLAYERS);
+            std::cout << "Game initialized with " << Logic::MAX_PLAYERS << " players" << std::endl;
         }
     }
 }
@@ -208,6 +213,8 @@ void GameServer::gameLoop() {
     std::cout << "Game loop started" << std::endl;
     
     auto lastTick = std::chrono::steady_clock::now();
+    auto lastProfileDump = lastTick;
+    auto lastStatsReport = lastTick;
     const auto tickDuration = std::chrono::milliseconds(static_cast<int>(TICK_RATE * 1000));
     
     while (m_running) {
@@ -219,8 +226,10 @@ void GameServer::gameLoop() {
         // Game tick
         if (now - lastTick >= tickDuration) {
             {
+                PROFILE_SCOPE(Profiler::Phase::ServerApplyInputs);
                 std::lock_guard<std::mutex> lock(m_inputMutex);
                 m_gameLogic.applyInputs(m_pendingInputs);
+                m_appliedSeqs = m_pendingSeqs;
             }
             
             m_gameLogic.tick();
@@ -229,6 +238,18 @@ void GameServer::gameLoop() {
             lastTick = now;
         }
         
+        // Profile dump on request (signal) or every PROFILE_DUMP_INTERVAL
+        if (Profiler::enabled &&
+            (Profiler::consumeDumpRequest() || now - lastProfileDump >= PROFILE_DUMP_INTERVAL)) {
+            Profiler::dump(std::cout);
+            lastProfileDump = now;
+        }
+        
+        if (now - lastStatsReport >= STATS_REPORT_INTERVAL) {
+            reportStats();
+            lastStatsReport = now;
+        }
+        
         // Small sleep to prevent busy waiting
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
@@ -248,92 +269,152 @@ void GameServer::handleClientMessages() {
     
     // Process messages from each connection
     for (auto& conn : m_connections) {
-        std::string data = conn->receive();
-        if (data.empty()) continue;
-        
-        Protocol::Message msg = parseMessage(data);
+        // Finish what a full socket refused earlier, ahead of anything new
+        conn->flush();
+        conn->receive(MAX_MESSAGE_SIZE);
+        m_parseErrors[static_cast<int>(ParseError::Oversized)] += conn->takeOverflowCount();
         
-        if (msg.type == Protocol::MessageType::INPUT) {
-            std::lock_guard<std::mutex> inputLock(m_inputMutex);
-            int playerId = msg.playerId >= 0 ? msg.playerId : conn->getPlayerId();
-            if (playerId >= 0 && playerId < GameLogic::MAX_PLAYERS) {
+        std::string_view line;
+        while (conn->nextLine(line)) {
+            if (line.empty()) continue;
+            
+            Protocol::Message msg;
+            ParseError error = parseMessage(line, msg);
+            if (error != ParseError::None) {
+                ++m_parseErrors[static_cast<int>(error)];
+                continue;
+            }
+            
+            if (msg.type == Protocol::MessageType::HELLO) {
+                using Encoding = Connection::Encoding;
+                Encoding encoding = msg.binary ? Encoding::BinaryFrames
+                                  : msg.compression ? Encoding::JsonFrames
+                                  : Encoding::JsonLines;
+                if (encoding != conn->getEncoding()) {
+                    conn->setEncoding(encoding);
+                    std::cout << "Client " << conn->getId() << " encoding: "
+                              << (msg.binary ? "binary frames" : msg.compression ? "JSON frames" : "JSON lines")
+                              << std::endl;
+                }
+            } else if (msg.type == Protocol::MessageType::PING) {
+                // Answered right away so the client measures network + loop latency only
+                m_controlWriter.begin();
+                writePong(m_controlWriter, msg.seq);
+                std::string_view pong = m_controlWriter.finish();
+                conn->send(conn->getEncoding() == Connection::Encoding::JsonLines
+                               ? pong : m_controlEncoder.encode(pong));
+            } else if (msg.type == Protocol::MessageType::INPUT) {
+                int playerId = msg.playerId >= 0 ? msg.playerId : conn->getPlayerId();
+                if (playerId < 0 || playerId >= Logic::MAX_PLAYERS) {
+                    ++m_parseErrors[static_cast<int>(ParseError::BadField)];
+                    continue;
+                }
+                std::lock_guard<std::mutex> inputLock(m_inputMutex);
                 m_pendingInputs[playerId].playerId = playerId;
                 m_pendingInputs[playerId].direction = msg.direction;
+                m_pendingSeqs[playerId] = msg.seq;
             }
         }
     }
 }
 
 void GameServer::broadcastGameState() {
-    Protocol::GameState state = m_gameLogic.getState();
-    std::string stateJson = serializeGameState(state);
+    std::string_view stateJson;
+    {
+        PROFILE_SCOPE(Profiler::Phase::ServerSerialize);
+        m_broadcastState = m_gameLogic.getState();
+        // Lets clients drop the predicted inputs this state already includes
+        for (auto& p : m_broadcastState.players) {
+            if (p.id >= 0 && p.id < Logic::MAX_PLAYERS) p.ack = m_appliedSeqs[p.id];
+        }
+        stateJson = serializeGameState(m_broadcastState);
+    }
     
     std::lock_guard<std::mutex> lock(m_connectionsMutex);
-    for (auto& conn : m_connections) {
-        conn->send(stateJson);
+    
+    // Build each negotiated encoding once, whatever the number of clients
+    using Encoding = Connection::Encoding;
+    bool wantJsonFrame = false;
+    bool wantBinaryFrame = false;
+    for (const auto& conn : m_connections) {
+        wantJsonFrame |= conn->getEncoding() == Encoding::JsonFrames;
+        wantBinaryFrame |= conn->getEncoding() == Encoding::BinaryFrames;
     }
-}
-
-std::string GameServer::serializeGameState(const Protocol::GameState& state) {
-    std::ostringstream oss;
-    oss << "{\"type\":\"state\",\"active\":" << (state.gameActive ? "true" : "false");
     
-    // Serialize players
-    oss << ",\"players\":[";
-    for (size_t i = 0; i < state.players.size(); ++i) {
-        const auto& p = state.players[i];
-        if (i > 0) oss << ",";
-        oss << "{\"id\":" << p.id 
-            << ",\"alive\":" << (p.alive ? "true" : "false")
-            << ",\"dir\":" << static_cast<int>(p.dir)
-            << ",\"score\":" << p.score
-            << ",\"body\":[";
-        for (size_t j = 0; j < p.body.size(); ++j) {
-            if (j > 0) oss << ",";
-            oss << "{\"x\":" << p.body[j].x << ",\"y\":" << p.body[j].y << "}";
+    std::string_view jsonFrame;
+    std::string_view binaryFrame;
+    if (wantJsonFrame) {
+        jsonFrame = encodeFrame(m_frameEncoder, stateJson, 0);
+    }
+    if (wantBinaryFrame) {
+        {
+            PROFILE_SCOPE(Profiler::Phase::ServerEncodeBinary);
+            BinarySnapshot::encode(m_broadcastState, m_binarySnapshot);
         }
-        oss << "]}";
+        binaryFrame = encodeFrame(m_binaryFrameEncoder, m_binarySnapshot, Frame::FLAG_BINARY);
     }
-    oss << "]";
     
-    // Serialize food
-    oss << ",\"food\":[";
-    for (size_t i = 0; i < state.food.size(); ++i) {
-        if (i > 0) oss << ",";
-        oss << "{\"x\":" << state.food[i].x << ",\"y\":" << state.food[i].y << "}";
+    PROFILE_SCOPE(Profiler::Phase::ServerBroadcast);
+    for (auto& conn : m_connections) {
+        switch (conn->getEncoding()) {
+            case Encoding::JsonLines:    conn->send(stateJson); break;
+            case Encoding::JsonFrames:   conn->send(jsonFrame); break;
+            case Encoding::BinaryFrames: conn->send(binaryFrame); break;
+        }
     }
-    oss << "]}\n";
-    
-    return oss.str();
 }
 
-Protocol::Message GameServer::parseMessage(const std::string& data) {
-    Protocol::Message msg;
-    msg.type = Protocol::MessageType::MSG_ERROR;
+std::string_view GameServer::encodeFrame(Frame::Encoder& encoder, std::string_view message,
+                                         std::uint8_t flags) {
+    // One measurement feeds both the frame stats and the profiler
+    auto start = std::chrono::steady_clock::now();
+    std::string_view frame = encoder.encode(message, flags);
+    const auto elapsedNs = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    Profiler::record(Profiler::Phase::ServerCompress, elapsedNs);
     
-    // Simple JSON parsing (in production, use a proper JSON library)
-    const size_t npos = static_cast<size_t>(-1);
-    size_t typePos = data.find("\"type\":\"input\"");
-    if (typePos != npos) {
-        msg.type = Protocol::MessageType::INPUT;
-        
-        // Extract direction
-        size_t dirPos = data.find("\"direction\":");
-        if (dirPos != npos) {
-            dirPos += 12; // Skip "direction":
-            int dirValue = std::stoi(data.substr(dirPos, 1));
-            msg.direction = static_cast<Protocol::Direction>(dirValue);
-        }
+    ++m_compressionStats.frames;
+    m_compressionStats.compressedFrames += encoder.lastCompressed() ? 1 : 0;
+    m_compressionStats.rawBytes += message.size();
+    m_compressionStats.wireBytes += frame.size();
+    m_compressionStats.totalNs += elapsedNs;
+    return frame;
+}
 
-        // Extract optional playerId
-        size_t pidPos = data.find("\"playerId\":");
-        if (pidPos != npos) {
-            pidPos += 11; // Skip "playerId":
-            msg.playerId = std::stoi(data.substr(pidPos));
+std::string_view GameServer::serializeGameState(const Protocol::GameState& state) {
+    m_stateWriter.begin();
+    writeGameState(m_stateWriter, state);
+    return m_stateWriter.finish();
+}
+
+ParseError GameServer::parseMessage(std::string_view data, Protocol::Message& msg) {
+    // Never throws: hostile or truncated input only bumps a counter
+    return parseClientMessage(data, msg);
+}
+
+void GameServer::reportStats() {
+    std::uint64_t total = 0;
+    for (int e = 1; e < PARSE_ERROR_KINDS; ++e) {
+        total += m_parseErrors[e];
+    }
+    if (total != m_reportedParseErrors) {
+        m_reportedParseErrors = total;
+        
+        std::cout << "Rejected client messages:";
+        for (int e = 1; e < PARSE_ERROR_KINDS; ++e) {
+            std::cout << ' ' << parseErrorName(static_cast<ParseError>(e)) << '=' << m_parseErrors[e];
         }
+        std::cout << std::endl;
     }
     
-    return msg;
+    const CompressionStats& c = m_compressionStats;
+    if (c.frames != m_reportedFrames) {
+        m_reportedFrames = c.frames;
+        
+        std::cout << "Frames: " << c.frames << " (" << c.compressedFrames << " compressed)"
+                  << ", ratio " << static_cast<double>(c.rawBytes) / static_cast<double>(c.wireBytes)
+                  << ", " << c.totalNs / c.frames << " ns/frame" << std::endl;
+    }
 }
 
 bool GameServer::isValidJson(const std::string& data) {
@@ -1,7 +1,10 @@
 #ifndef GAMESERVER_H
 #define GAMESERVER_H
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <thread>
@@ -10,7 +13,12 @@
 #include <chrono>
 
 #include "GameLogic.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
 #include "Connection.h"
+#include "BinarySnapshot.h"
+#include "Frame.h"
+#include "Profiler.h"
 #include "Protocol.h"
 
 /**
@@ -20,6 +28,12 @@ class GameServer {
 public:
     static constexpr int DEFAULT_PORT = 8765;
     static constexpr float TICK_RATE = 0.12f; // 120ms per game tick
+    static constexpr std::chrono::seconds PROFILE_DUMP_INTERVAL{60}; // with GAMESERVER_PROFILING
+    static constexpr std::chrono::seconds STATS_REPORT_INTERVAL{60}; // only when counts changed
+    static constexpr size_t MIN_COMPRESS_SIZE = Frame::DEFAULT_MIN_COMPRESS_SIZE;
+    
+    /// Arena preset hosted by this server
+    using Logic = ClassicGameLogic;
     
     GameServer(int port = DEFAULT_PORT);
     ~GameServer();
@@ -51,10 +65,41 @@ private:
     std::vector<std::unique_ptr<Connection>> m_connections;
     std::mutex m_connectionsMutex;
     
-    GameLogic m_gameLogic;
-    std::array<Protocol::InputCommand, GameLogic::MAX_PLAYERS> m_pendingInputs;
+    Logic m_gameLogic;
+    Logic::InputArray m_pendingInputs;
+    std::array<std::uint32_t, Logic::MAX_PLAYERS> m_pendingSeqs{};  // seq of each pending input
     std::mutex m_inputMutex;
     
+    // Seq of the input each player's last tick applied, echoed as "ack" (game thread only)
+    std::array<std::uint32_t, Logic::MAX_PLAYERS> m_appliedSeqs{};
+    
+    // Snapshot and its text, reused every tick (game thread only)
+    Protocol::GameState m_broadcastState;
+    JsonWriter m_stateWriter;
+    
+    // Rejected client messages by ParseError (game thread only)
+    static constexpr int PARSE_ERROR_KINDS = static_cast<int>(ParseError::Count);
+    std::array<std::uint64_t, PARSE_ERROR_KINDS> m_parseErrors{};
+    std::uint64_t m_reportedParseErrors{0};
+    
+    // Pong replies (game thread only); never compressed, not in the frame stats
+    JsonWriter m_controlWriter;
+    Frame::Encoder m_controlEncoder{Frame::MAX_RAW_SIZE};
+    
+    // Frames for clients that negotiated them, built once per tick
+    Frame::Encoder m_frameEncoder{MIN_COMPRESS_SIZE};
+    Frame::Encoder m_binaryFrameEncoder{MIN_COMPRESS_SIZE};
+    std::string m_binarySnapshot;
+    struct CompressionStats {
+        std::uint64_t frames{0};
+        std::uint64_t compressedFrames{0};
+        std::uint64_t rawBytes{0};
+        std::uint64_t wireBytes{0};
+        std::uint64_t totalNs{0};
+    };
+    CompressionStats m_compressionStats;
+    std::uint64_t m_reportedFrames{0};
+    
     std::thread m_acceptThread;
     std::thread m_gameThread;
     
@@ -63,9 +108,14 @@ private:
     void gameLoop();
     void handleClientMessages();
     void broadcastGameState();
+    std::string_view encodeFrame(Frame::Encoder& encoder, std::string_view message, std::uint8_t flags);
     
-    std::string serializeGameState(const Protocol::GameState& state);
-    Protocol::Message parseMessage(const std::string& data);
+    /**
+     * @brief Serialize a snapshot (view valid until the next call)
+     */
+    std::string_view serializeGameState(const Protocol::GameState& state);
+    ParseError parseMessage(std::string_view data, Protocol::Message& msg);
+    void reportStats();
     bool isValidJson(const std::string& data);
 };
 
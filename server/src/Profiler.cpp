@@ -0,0 +1,117 @@
+#include "Profiler.h"
+
+#ifdef GAMESERVER_PROFILING
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Profiler {
+
+namespace {
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "tick.movePlayers",
+    "tick.resolveFood",
+    "tick.resolveCollisions",
+    "server.applyInputs",
+    "server.serialize",
+    "server.encodeBinary",
+    "server.compress",
+    "server.broadcast"
+};
+
+struct ThreadHistograms {
+    Histogram phases[PHASE_COUNT];
+};
+
+// Blocks outlive their threads so dump() never reads freed memory
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadHistograms>> g_registry;
+
+std::atomic<bool> g_dumpRequested{false};
+
+ThreadHistograms* registerThread() {
+    auto block = std::make_unique<ThreadHistograms>();
+    for (auto& h : block->phases) {
+        for (auto& b : h.buckets) b.store(0, std::memory_order_relaxed);
+        h.count.store(0, std::memory_order_relaxed);
+        h.totalNs.store(0, std::memory_order_relaxed);
+        h.maxNs.store(0, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    g_registry.push_back(std::move(block));
+    return g_registry.back().get();
+}
+
+// Upper bound of the bucket holding the given quantile
+std::uint64_t quantileNs(const std::uint64_t (&buckets)[BUCKET_COUNT],
+                         std::uint64_t count, double q) {
+    const auto target = static_cast<std::uint64_t>(q * static_cast<double>(count));
+    std::uint64_t seen = 0;
+    for (int b = 0; b < BUCKET_COUNT; ++b) {
+        seen += buckets[b];
+        if (seen > target) return b == 0 ? 0 : (1ull << b);
+    }
+    return 1ull << (BUCKET_COUNT - 1);
+}
+
+} // namespace
+
+Histogram& threadHistogram(Phase phase) {
+    thread_local ThreadHistograms* histograms = registerThread();
+    return histograms->phases[static_cast<int>(phase)];
+}
+
+void dump(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    out << "=== Tick profile (ns) ===" << '\n';
+    out << std::left << std::setw(24) << "phase" << std::right
+        << std::setw(10) << "count" << std::setw(10) << "mean"
+        << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "max" << '\n';
+
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        std::uint64_t buckets[BUCKET_COUNT] = {};
+        std::uint64_t count = 0;
+        std::uint64_t total = 0;
+        std::uint64_t maxNs = 0;
+
+        for (const auto& block : g_registry) {
+            const Histogram& h = block->phases[p];
+            for (int b = 0; b < BUCKET_COUNT; ++b) {
+                buckets[b] += h.buckets[b].load(std::memory_order_relaxed);
+            }
+            count += h.count.load(std::memory_order_relaxed);
+            total += h.totalNs.load(std::memory_order_relaxed);
+            maxNs = std::max(maxNs, h.maxNs.load(std::memory_order_relaxed));
+        }
+
+        if (count == 0) continue;
+
+        out << std::left << std::setw(24) << PHASE_NAMES[p] << std::right
+            << std::setw(10) << count
+            << std::setw(10) << total / count
+            << std::setw(10) << quantileNs(buckets, count, 0.50)
+            << std::setw(10) << quantileNs(buckets, count, 0.99)
+            << std::setw(10) << maxNs << '\n';
+    }
+
+    out.flush();
+}
+
+void requestDump() {
+    g_dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+bool consumeDumpRequest() {
+    return g_dumpRequested.exchange(false, std::memory_order_relaxed);
+}
+
+} // namespace Profiler
+
+#endif // GAMESERVER_PROFILING
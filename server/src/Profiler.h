@@ -0,0 +1,132 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Built-in per-phase tick profiler
+ *
+ * PROFILE_SCOPE(phase) times the enclosing block and records it into a
+ * histogram owned by the calling thread. Each thread writes only its own
+ * histograms, using relaxed atomic stores, so recording takes no lock and
+ * contends with nothing. dump() may run on any thread at any time and
+ * merges every thread's histograms.
+ *
+ * Profiling is compiled in only when GAMESERVER_PROFILING is defined
+ * (CMake option GAMESERVER_ENABLE_PROFILING). Otherwise PROFILE_SCOPE
+ * expands to nothing and the functions below are empty inlines.
+ */
+namespace Profiler {
+
+enum class Phase {
+    TickMove,
+    TickFood,
+    TickCollisions,
+    ServerApplyInputs,
+    ServerSerialize,
+    ServerEncodeBinary,
+    ServerCompress,
+    ServerBroadcast,
+    Count
+};
+
+constexpr int PHASE_COUNT = static_cast<int>(Phase::Count);
+
+#ifdef GAMESERVER_PROFILING
+
+constexpr bool enabled = true;
+
+/// Power-of-two nanosecond buckets: bucket b holds durations < 2^b ns
+constexpr int BUCKET_COUNT = 40;
+
+struct Histogram {
+    std::atomic<std::uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<std::uint64_t> count;
+    std::atomic<std::uint64_t> totalNs;
+    std::atomic<std::uint64_t> maxNs;
+};
+
+/**
+ * @brief Histogram of the calling thread for a phase (registers the thread
+ * on first use)
+ */
+Histogram& threadHistogram(Phase phase);
+
+inline void record(Phase phase, std::uint64_t ns) {
+    Histogram& h = threadHistogram(phase);
+
+    int bucket = 0;
+    for (std::uint64_t v = ns; v != 0 && bucket < BUCKET_COUNT - 1; v >>= 1) {
+        ++bucket;
+    }
+
+    // Single writer per histogram: load + store instead of an RMW
+    auto bump = [](std::atomic<std::uint64_t>& a, std::uint64_t by) {
+        a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    };
+    bump(h.buckets[bucket], 1);
+    bump(h.count, 1);
+    bump(h.totalNs, ns);
+    if (ns > h.maxNs.load(std::memory_order_relaxed)) {
+        h.maxNs.store(ns, std::memory_order_relaxed);
+    }
+}
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Phase phase)
+        : m_phase(phase), m_start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        record(m_phase, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Phase m_phase;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Write count, mean, p50, p99 and max per phase, merged over threads
+ */
+void dump(std::ostream& out);
+
+/**
+ * @brief Ask for a dump from a signal handler (async-signal-safe)
+ */
+void requestDump();
+
+/**
+ * @brief True once per requestDump() call
+ */
+bool consumeDumpRequest();
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(phase) \
+    ::Profiler::ScopedTimer PROFILE_CONCAT(profileScope_, __LINE__)(phase)
+
+#else
+
+constexpr bool enabled = false;
+
+inline void record(Phase, std::uint64_t) {}
+inline void dump(std::ostream&) {}
+inline void requestDump() {}
+inline bool consumeDumpRequest() { return false; }
+
+#define PROFILE_SCOPE(phase) ((void)0)
+
+#endif // GAMESERVER_PROFILING
+
+} // namespace Profiler
+
+#endif // PROFILER_H
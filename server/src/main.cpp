@@ -1,4 +1,5 @@
 #include "GameServer.h"
+#include "Profiler.h"
 #include <iostream>
 #include <csignal>
 
@@ -12,6 +13,11 @@ void signalHandler(int signal) {
     }
 }
 
+void profileSignalHandler(int) {
+    // Only sets a flag; the game loop prints the dump
+    Profiler::requestDump();
+}
+
 int main(int argc, char* argv[]) {
     int port = GameServer::DEFAULT_PORT;
     
@@ -35,6 +41,15 @@ int main(int argc, char* argv[]) {
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
     
+    // Profile dump on demand (kill -USR1 <pid>, or Ctrl+Break on Windows)
+    if (Profiler::enabled) {
+    #if defined(SIGUSR1)
+        std::signal(SIGUSR1, profileSignalHandler);
+    #elif defined(SIGBREAK)
+        std::signal(SIGBREAK, profileSignalHandler);
+    #endif
+    }
+    
     if (!server.start()) {
         std::cerr << "Failed to start server" << std::endl;
         return 1;